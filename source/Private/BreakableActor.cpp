@@ -3,6 +3,8 @@
 #include "Kismet/GameplayStatics.h"
 #include "Components/CapsuleComponent.h"
 #include "GeometryCollection/GeometryCollectionComponent.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 ABreakableActor::ABreakableActor()
 {
@@ -12,6 +14,7 @@ ABreakableActor::ABreakableActor()
 	GeometryCollection->SetGenerateOverlapEvents(true);
 	GeometryCollection->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GeometryCollection->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+	GeometryCollection->SetCollisionResponseToChannel(ECC_Hitbox, ECollisionResponse::ECR_Block);
 
 
 	SetRootComponent(GeometryCollection);
@@ -34,6 +37,14 @@ void ABreakableActor::OnChaosBreakEvent(const FChaosBreakEvent& BreakEvent)
 {
 }
 
+/// <summary>
+/// Breaks every cluster at once, for hits without a weapon's field like area attacks
+/// </summary>
+void ABreakableActor::Shatter()
+{
+	GeometryCollection->CrumbleActiveClusters();
+}
+
 void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
 	if (bHit)
@@ -57,7 +68,15 @@ void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 	{
 		int32 max = ObjectsToSpawn.Num();
 		int32 idx = FMath::RandRange(0, max - 1);
-		World->SpawnActor<ATreasure>(ObjectsToSpawn[idx], GetActorLocation() + FVector::UpVector * 50.f, GetActorRotation());
+		const FVector SpawnLocation = GetActorLocation() + FVector::UpVector * 50.f;
+		if (UActorPoolSubsystem* Pool = World->GetSubsystem<UActorPoolSubsystem>())
+		{
+			Pool->RequestSpawn(ObjectsToSpawn[idx], FTransform(GetActorRotation(), SpawnLocation));
+		}
+		else
+		{
+			World->SpawnActor<ATreasure>(ObjectsToSpawn[idx], SpawnLocation, GetActorRotation());
+		}
 	}
 	Capsule->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 
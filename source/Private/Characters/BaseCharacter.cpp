@@ -3,11 +3,20 @@
 #include "Kismet/GameplayStatics.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/AttributeComponent.h"
+#include "Components/FactionComponent.h"
+#include "Components/HitboxComponent.h"
+#include "Items/WeaponTrajectory.h"
+#include "Animation/AnimMontage.h"
+#include "HUD/CombatTextSubsystem.h"
+#include "Combat/StatusEffectSubsystem.h"
+#include "GameFramework/CharacterMovementComponent.h"
 
 ABaseCharacter::ABaseCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 	Attributes = CreateDefaultSubobject<UAttributeComponent>(TEXT("AttributeComponent"));
+	Faction = CreateDefaultSubobject<UFactionComponent>(TEXT("FactionComponent"));
+	Hitboxes = CreateDefaultSubobject<UHitboxComponent>(TEXT("HitboxComponent"));
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 }
 
@@ -18,7 +27,9 @@ ABaseCharacter::ABaseCharacter()
 /// <returns>Index of the section played</returns>
 int32 ABaseCharacter::PlayAttackMontage()
 {
-	return PlayRandomMontageSection(AttackMontage, AttackMontageSections);
+	const int32 Selection = PlayRandomMontageSection(AttackMontage, AttackMontageSections);
+	AttackSection = AttackMontageSections.IsValidIndex(Selection) ? AttackMontageSections[Selection] : NAME_None;
+	return Selection;
 }
 
 /// <summary>
@@ -26,6 +37,7 @@ int32 ABaseCharacter::PlayAttackMontage()
 /// </summary>
 void ABaseCharacter::StopAttackMontage()
 {
+	AttackSection = NAME_None;
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 	if (AnimInstance)
 	{
@@ -33,6 +45,42 @@ void ABaseCharacter::StopAttackMontage()
 	}
 }
 
+/// <summary>
+/// World space blade pose of Weapon from the baked trajectory of the attack section playing, so swings don't need the animated pose.
+/// False when there is no bake for this weapon and section, the montage is paused or stopped, or the section has played past its end
+/// </summary>
+bool ABaseCharacter::GetBakedBladePose(const AWeapon* Weapon, FMeleeBladePose& OutPose) const
+{
+	if (AttackTrajectories == nullptr || AttackSection.IsNone() || AttackMontage == nullptr || !AttackTrajectories->IsBakedFor(Weapon))
+	{
+		return false;
+	}
+
+	// The montage position follows the play rate and holds still while paused, a stunned swing doesn't keep sweeping
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	const int32 SectionIndex = AttackMontage->GetSectionIndex(AttackSection);
+	if (AnimInstance == nullptr || SectionIndex == INDEX_NONE || !AnimInstance->Montage_IsPlaying(AttackMontage))
+	{
+		return false;
+	}
+
+	float SectionStart = 0.f;
+	float SectionEnd = 0.f;
+	AttackMontage->GetSectionStartAndEndTime(SectionIndex, SectionStart, SectionEnd);
+	const float SectionTime = AnimInstance->Montage_GetPosition(AttackMontage) - SectionStart;
+	FMeleeBladePose ActorPose;
+	if (!AttackTrajectories->SampleBlade(AttackSection, SectionTime, ActorPose))
+	{
+		return false;
+	}
+
+	const FTransform& ActorTransform = GetActorTransform();
+	OutPose.Base = ActorTransform.TransformPosition(ActorPose.Base);
+	OutPose.Tip = ActorTransform.TransformPosition(ActorPose.Tip);
+	OutPose.Rotation = ActorTransform.TransformRotation(ActorPose.Rotation);
+	return true;
+}
+
 /// <summary>
 /// Helper to disable the collision on the Capsule Component
 /// </summary>
@@ -153,18 +201,57 @@ bool ABaseCharacter::CanDodge()
 }
 /// <summary>
 /// Base implementation for when the character dies
-/// Adds the Dead tag, plays the death montage, and disables collision
+/// Marks the faction dead, plays the death montage, and disables collision
 /// </summary>
 void ABaseCharacter::Die_Implementation()
 {
-	Tags.Add(FName("Dead"));
+	Faction->SetDead(true);
+	if (UStatusEffectSubsystem* StatusEffects = GetWorld()->GetSubsystem<UStatusEffectSubsystem>())
+	{
+		StatusEffects->ClearEffects(this);
+	}
 	if (DeathMontage)
 	{
 		PlayMontage(DeathMontage);
 	}
 	DisableCapsule();
 	GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Hitboxes->SetHitboxesEnabled(false);
+	SetWeaponCollisionEnable(ECollisionEnabled::NoCollision);
+}
+
+/// <summary>
+/// Undoes Die and whatever else the last life left behind, for characters that are reused instead of respawned.
+/// Attributes, the dead flag, status effects and collision go back to the class defaults, and the animation instance is
+/// reinitialised so the death montage doesn't hold its final pose
+/// </summary>
+void ABaseCharacter::ResetCharacterState()
+{
+	const ABaseCharacter* Defaults = GetClass()->GetDefaultObject<ABaseCharacter>();
+
+	if (Attributes)
+	{
+		Attributes->ResetAttributes();
+	}
+	Faction->SetDead(false);
+	UWorld* World = GetWorld();
+	if (UStatusEffectSubsystem* StatusEffects = World ? World->GetSubsystem<UStatusEffectSubsystem>() : nullptr)
+	{
+		StatusEffects->ClearEffects(this);
+	}
+
+	GetCapsuleComponent()->SetCollisionEnabled(Defaults->GetCapsuleComponent()->GetCollisionEnabled());
+	GetMesh()->SetCollisionEnabled(Defaults->GetMesh()->GetCollisionEnabled());
+	Hitboxes->SetHitboxesEnabled(true);
 	SetWeaponCollisionEnable(ECollisionEnabled::NoCollision);
+
+	GetMesh()->SetComponentTickEnabled(true);
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.f);
+	}
+	GetMesh()->InitAnim(true);
+	AttackSection = NAME_None;
 }
 
 /// <summary>
@@ -215,6 +302,19 @@ void ABaseCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor* H
 	}
 }
 
+/// <summary>
+/// Clears the character's status effects, so UStatusEffectSubsystem doesn't keep ticking them after it leaves play
+/// </summary>
+void ABaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UWorld* World = GetWorld();
+	if (UStatusEffectSubsystem* StatusEffects = World ? World->GetSubsystem<UStatusEffectSubsystem>() : nullptr)
+	{
+		StatusEffects->ClearEffects(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 /// <summary>
 /// The event class for an Actor taking damage
 /// </summary>
@@ -224,20 +324,41 @@ float ABaseCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageE
 	return DamageAmount;
 }
 
+/// <summary>
+/// Rescales the walk speed the character has set by the change in slow, so it stays right whatever set the speed
+/// </summary>
+void ABaseCharacter::SetStatusEffects(bool bInStunned, float InSlowMultiplier)
+{
+	if (InSlowMultiplier != SlowMultiplier)
+	{
+		GetCharacterMovement()->MaxWalkSpeed *= InSlowMultiplier / SlowMultiplier;
+		SlowMultiplier = InSlowMultiplier;
+	}
+	bStunned = bInStunned;
+}
+
 /// <summary>
 /// Handles taking damage and will potentially trigger Die on the character
 /// </summary>
 /// <param name="Damage">Damage to apply</param>
 void ABaseCharacter::HandleDamage(float Damage)
 {
-	if (Attributes)
+	// Already dead, Die must only run once
+	if (!IsAlive())
+	{
+		return;
+	}
+
+	Attributes->ChangeHealth(-Damage);
+
+	if (UCombatTextSubsystem* CombatText = GetWorld()->GetSubsystem<UCombatTextSubsystem>())
 	{
-		Attributes->ChangeHealth(-Damage);
+		CombatText->AddDamage(this, Damage);
+	}
 
-		if (!IsAlive())
-		{
-			Die();
-		}
+	if (!IsAlive())
+	{
+		Die();
 	}
 }
 
@@ -334,7 +455,7 @@ void ABaseCharacter::DodgeEnd()
 }
 
 /// <summary>
-/// Invoked when the AnimNotify event is triggered on the blueprint to indicate the attack montage is done
+/// Invoked by UAnimNotify_AttackEnd, or the AnimNotify event on the blueprint, to indicate the attack montage is done
 /// </summary>
 void ABaseCharacter::AttackEnd()
 {
@@ -342,7 +463,7 @@ void ABaseCharacter::AttackEnd()
 
 /// <summary>
 /// Sets the collision enabled flag on the currently Equipped Weapon
-/// Typically invoked in blueprints via the anim notify event from the attack montage
+/// Typically invoked by UAnimNotifyState_WeaponCollision on the attack montage
 /// </summary>
 /// <param name="CollisionEnabled"></param>
 void ABaseCharacter::SetWeaponCollisionEnable(ECollisionEnabled::Type CollisionEnabled)
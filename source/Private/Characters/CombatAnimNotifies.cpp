@@ -0,0 +1,155 @@
+#include "Characters/CombatAnimNotifies.h"
+#include "Characters/SlashCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Slash/SlashStats.h"
+#include "Slash/SlashBenchmark.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Native Combat Notifies"), STAT_NativeCombatNotifies, STATGROUP_Slash);
+
+namespace
+{
+	template <typename CharacterType>
+	CharacterType* GetNotifiedCharacter(const USkeletalMeshComponent* MeshComp)
+	{
+		CharacterType* Character = MeshComp ? Cast<CharacterType>(MeshComp->GetOwner()) : nullptr;
+		if (Character)
+		{
+			INC_DWORD_STAT(STAT_NativeCombatNotifies);
+		}
+		return Character;
+	}
+}
+
+void UAnimNotifyState_WeaponCollision::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+	if (ABaseCharacter* Character = GetNotifiedCharacter<ABaseCharacter>(MeshComp))
+	{
+		Character->SetWeaponCollisionEnable(ECollisionEnabled::QueryOnly);
+	}
+}
+
+void UAnimNotifyState_WeaponCollision::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+	if (ABaseCharacter* Character = GetNotifiedCharacter<ABaseCharacter>(MeshComp))
+	{
+		Character->SetWeaponCollisionEnable(ECollisionEnabled::NoCollision);
+	}
+}
+
+FString UAnimNotifyState_WeaponCollision::GetNotifyName_Implementation() const
+{
+	return TEXT("Weapon Collision");
+}
+
+void UAnimNotifyState_Dodge::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+	if (ABaseCharacter* Character = GetNotifiedCharacter<ABaseCharacter>(MeshComp))
+	{
+		Character->DodgeEnd();
+	}
+}
+
+FString UAnimNotifyState_Dodge::GetNotifyName_Implementation() const
+{
+	return TEXT("Dodge");
+}
+
+void UAnimNotify_AttackEnd::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+	if (ABaseCharacter* Character = GetNotifiedCharacter<ABaseCharacter>(MeshComp))
+	{
+		Character->AttackEnd();
+	}
+}
+
+FString UAnimNotify_AttackEnd::GetNotifyName_Implementation() const
+{
+	return TEXT("Attack End");
+}
+
+void UAnimNotify_HitReactEnd::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+	if (ASlashCharacter* Character = GetNotifiedCharacter<ASlashCharacter>(MeshComp))
+	{
+		Character->HitReactEnd();
+	}
+}
+
+FString UAnimNotify_HitReactEnd::GetNotifyName_Implementation() const
+{
+	return TEXT("Hit React End");
+}
+
+void UAnimNotify_EquipAttach::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+	if (ASlashCharacter* Character = GetNotifiedCharacter<ASlashCharacter>(MeshComp))
+	{
+		Character->EquipEnd(bEquip);
+	}
+}
+
+FString UAnimNotify_EquipAttach::GetNotifyName_Implementation() const
+{
+	return bEquip ? TEXT("Equip Attach") : TEXT("Unequip Attach");
+}
+
+/// <summary>
+/// Fires one swing's notifies, collision window begin and end plus attack end, for each of 100 characters every frame, once
+/// through the native notifies and once the way the animation blueprints called the BlueprintCallable functions, a reflected
+/// ProcessEvent per call. The character default object has no weapon and empty ends, so only the dispatch is timed. The old
+/// path also ran the anim blueprint's own notify event before that call, so its cost here is a lower bound
+/// </summary>
+static void RunCombatNotifyBenchmark(int32 NumFrames)
+{
+	const int32 NumCharacters = 100;
+
+	ABaseCharacter* Character = GetMutableDefault<ABaseCharacter>();
+	USkeletalMeshComponent* MeshComp = Character->GetMesh();
+	UAnimNotifyState_WeaponCollision* CollisionNotify = GetMutableDefault<UAnimNotifyState_WeaponCollision>();
+	UAnimNotify_AttackEnd* AttackEndNotify = GetMutableDefault<UAnimNotify_AttackEnd>();
+	const FAnimNotifyEventReference EventReference;
+
+	UFunction* SetWeaponCollisionEnable = Character->FindFunctionChecked(TEXT("SetWeaponCollisionEnable"));
+	UFunction* AttackEnd = Character->FindFunctionChecked(TEXT("AttackEnd"));
+	struct FSetWeaponCollisionEnableParams
+	{
+		TEnumAsByte<ECollisionEnabled::Type> CollisionEnabled;
+	};
+
+	FSlashBenchmarkTimer NativeTimer;
+	FSlashBenchmarkTimer BlueprintTimer;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		NativeTimer.Begin();
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			CollisionNotify->NotifyBegin(MeshComp, nullptr, 0.f, EventReference);
+			CollisionNotify->NotifyEnd(MeshComp, nullptr, EventReference);
+			AttackEndNotify->Notify(MeshComp, nullptr, EventReference);
+		}
+		NativeTimer.End();
+
+		BlueprintTimer.Begin();
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			FSetWeaponCollisionEnableParams Params{ ECollisionEnabled::QueryOnly };
+			Character->ProcessEvent(SetWeaponCollisionEnable, &Params);
+			Params.CollisionEnabled = ECollisionEnabled::NoCollision;
+			Character->ProcessEvent(SetWeaponCollisionEnable, &Params);
+			Character->ProcessEvent(AttackEnd, nullptr);
+		}
+		BlueprintTimer.End();
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("CombatNotify Benchmark: %d characters, %d notifies/frame, %d frames: native %s, blueprint calls %s"),
+		NumCharacters, NumCharacters * 3, NumFrames, *NativeTimer.ToString(), *BlueprintTimer.ToString());
+}
+
+static FSlashBenchmarkCommand CombatNotifyBenchmarkCommand(TEXT("CombatNotify"),
+	TEXT("Compares native combat notifies against reflected BlueprintCallable calls for a swing by each of 100 characters per frame"), &RunCombatNotifyBenchmark);
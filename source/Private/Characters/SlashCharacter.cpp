@@ -12,10 +12,14 @@
 #include "HUD/SlashHUD.h"
 #include "HUD/SlashOverlay.h"
 #include "Components/AttributeComponent.h"
+#include "Components/FactionComponent.h"
+#include "Spatial/SpatialHashSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 ASlashCharacter::ASlashCharacter()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// The HUD follows the attribute component's delegates, nothing left to tick
+	PrimaryActorTick.bCanEverTick = false;
 	AutoPossessPlayer = EAutoReceiveInput::Player0;
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationRoll = false;
@@ -26,8 +30,8 @@ ASlashCharacter::ASlashCharacter()
 	GetMesh()->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
 	GetMesh()->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
-	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
-	GetMesh()->SetGenerateOverlapEvents(true);
+	// Weapons hit the bone driven hitboxes instead, pickups overlap the capsule
+	GetMesh()->SetGenerateOverlapEvents(false);
 }
 
 void ASlashCharacter::BeginPlay()
@@ -42,11 +46,32 @@ void ASlashCharacter::BeginPlay()
 		}
 	}
 
-	Tags.Add(FName("EngageableTarget"));
+	Faction->SetTeam(ETeam::ET_Player);
+	Faction->SetTargetable(true);
+
+	UWorld* World = GetWorld();
+	if (USpatialHashSubsystem* SpatialHash = World ? World->GetSubsystem<USpatialHashSubsystem>() : nullptr)
+	{
+		SpatialHash->RegisterActor(this);
+	}
 
 	InitializeHUD();
 }
 
+void ASlashCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UWorld* World = GetWorld();
+	if (USpatialHashSubsystem* SpatialHash = World ? World->GetSubsystem<USpatialHashSubsystem>() : nullptr)
+	{
+		SpatialHash->UnregisterActor(this);
+	}
+	if (SlashOverlay)
+	{
+		SlashOverlay->UnbindAttributes();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 /// <summary>
 /// Initializes the HUD and caches SlashOverlay
 /// </summary>
@@ -64,10 +89,7 @@ void ASlashCharacter::InitializeHUD()
 				SlashOverlay = SlashHud->GetSlashOverlay();
 				if (SlashOverlay)
 				{
-					SlashOverlay->SetHealthBarPercent(1.f);
-					SlashOverlay->SetStaminaBarPercent(1.f);
-					SlashOverlay->SetCoinsValue(0);
-					SlashOverlay->SetSoulsValue(0);
+					SlashOverlay->BindAttributes(Attributes);
 				}
 			}
 		}
@@ -201,7 +223,7 @@ void ASlashCharacter::PlayEquipMontage(const bool bEquip)
 }
 
 /// <summary>
-/// Called via Anim Notify on the animation blueprint when the Attack Montage is finished
+/// Called by the native combat notifies, or the animation blueprint, when the Attack Montage is finished
 /// </summary>
 void ASlashCharacter::AttackEnd()
 {
@@ -210,7 +232,7 @@ void ASlashCharacter::AttackEnd()
 }
 
 /// <summary>
-/// Called via Anim Notify on the animation blueprint when the Dodge Montage is finished
+/// Called by the native combat notifies, or the animation blueprint, when the Dodge Montage is finished
 /// </summary>
 void ASlashCharacter::DodgeEnd()
 {
@@ -219,7 +241,7 @@ void ASlashCharacter::DodgeEnd()
 }
 
 /// <summary>
-/// Called via Anim Notify on the animation blueprint when the Hit React Montage is finished
+/// Called by the native combat notifies, or the animation blueprint, when the Hit React Montage is finished
 /// </summary>
 void ASlashCharacter::HitReactEnd()
 {
@@ -230,7 +252,7 @@ void ASlashCharacter::HitReactEnd()
 }
 
 /// <summary>
-/// Called via Anim Notify on the animation blueprint when the Equip Montage is finished
+/// Called by the native combat notifies, or the animation blueprint, when the Equip Montage is finished
 /// </summary>
 void ASlashCharacter::EquipEnd(const bool bEquipped)
 {
@@ -258,26 +280,17 @@ void ASlashCharacter::Die_Implementation()
 	ActionState = EActionState::EAS_Dead;
 }
 
-/// <summary>
-/// Called when the character takes damage
-/// Updates SlashOverlay after we take damage
-/// </summary>
-void ASlashCharacter::HandleDamage(float Damage)
-{
-	Super::HandleDamage(Damage);
-	if (SlashOverlay && Attributes)
-	{
-		SlashOverlay->SetHealthBarPercent(Attributes->GetHealthPercent());
-	}
-}
-
 /// <summary>
 /// Implementation for GetHit
 /// Sets ActionState and then does default behavior
 /// </summary>
 void ASlashCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
-	ActionState = EActionState::EAS_HitReaction;
+	// Queued damage is applied before the hit, a killing blow must not leave EAS_Dead
+	if (IsAlive())
+	{
+		ActionState = EActionState::EAS_HitReaction;
+	}
 	Super::GetHit_Implementation(ImpactPoint, Hitter);
 }
 
@@ -286,7 +299,7 @@ void ASlashCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 /// </summary>
 bool ASlashCharacter::CanAttack()
 {
-	return ActionState == EActionState::EAS_Unoccupied && CharacterState != ECharacterState::ECS_Unequipped;
+	return ActionState == EActionState::EAS_Unoccupied && CharacterState != ECharacterState::ECS_Unequipped && !IsStunned();
 }
 
 /// <summary>
@@ -294,7 +307,7 @@ bool ASlashCharacter::CanAttack()
 /// </summary>
 bool ASlashCharacter::CanDisarm()
 {
-	return CharacterState != ECharacterState::ECS_Unequipped && ActionState == EActionState::EAS_Unoccupied;
+	return CharacterState != ECharacterState::ECS_Unequipped && ActionState == EActionState::EAS_Unoccupied && !IsStunned();
 }
 
 /// <summary>
@@ -302,7 +315,7 @@ bool ASlashCharacter::CanDisarm()
 /// </summary>
 bool ASlashCharacter::CanArm()
 {
-	return CharacterState == ECharacterState::ECS_Unequipped && ActionState == EActionState::EAS_Unoccupied;;
+	return CharacterState == ECharacterState::ECS_Unequipped && ActionState == EActionState::EAS_Unoccupied && !IsStunned();
 }
 
 /// <summary>
@@ -310,7 +323,7 @@ bool ASlashCharacter::CanArm()
 /// </summary>
 bool ASlashCharacter::CanMove()
 {
-	return ActionState == EActionState::EAS_Unoccupied;
+	return ActionState == EActionState::EAS_Unoccupied && !IsStunned();
 }
 
 /// <summary>
@@ -326,7 +339,20 @@ bool ASlashCharacter::CanJump()
 /// </summary>
 bool ASlashCharacter::CanDodge()
 {
-	return ActionState == EActionState::EAS_Unoccupied && Super::CanDodge();
+	return ActionState == EActionState::EAS_Unoccupied && !IsStunned() && Super::CanDodge();
+}
+
+/// <summary>
+/// A stun cuts the current attack short, the Can helpers block every action until it ends
+/// </summary>
+void ASlashCharacter::SetStatusEffects(bool bInStunned, float InSlowMultiplier)
+{
+	if (bInStunned && !IsStunned() && ActionState == EActionState::EAS_Attacking)
+	{
+		StopAttackMontage();
+		AttackEnd();
+	}
+	Super::SetStatusEffects(bInStunned, InSlowMultiplier);
 }
 
 void ASlashCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -342,16 +368,6 @@ void ASlashCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComp
 	}
 }
 
-void ASlashCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	if (SlashOverlay && Attributes)
-	{
-		SlashOverlay->SetStaminaBarPercent(Attributes->GetStaminaPercent());
-	}
-}
-
 /// <summary>
 /// Set when the character is overlapping with an item in the world
 /// </summary>
@@ -369,11 +385,6 @@ void ASlashCharacter::PickupTreasure(ATreasure* Treasure)
 	if (Attributes)
 	{
 		Attributes->ChangeGold(Treasure->GetValue());
-
-		if (SlashOverlay)
-		{
-			SlashOverlay->SetCoinsValue(Attributes->GetGold());
-		}
 	}
 }
 
@@ -385,11 +396,6 @@ void ASlashCharacter::PickupSoul(ASoul* Soul)
 	if (Attributes)
 	{
 		Attributes->ChangeSouls(Soul->GetSoulValue());
-
-		if (SlashOverlay)
-		{
-			SlashOverlay->SetSoulsValue(Attributes->GetSouls());
-		}
 	}
 }
 
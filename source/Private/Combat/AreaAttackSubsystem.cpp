@@ -0,0 +1,245 @@
+#include "Combat/AreaAttackSubsystem.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "BreakableActor.h"
+#include "Components/FactionComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Interfaces/HitInterface.h"
+#include "Kismet/GameplayStatics.h"
+#include "Slash/SlashCollision.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("AreaAttack Query"), STAT_AreaAttackQuery, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("AreaAttack Resolve"), STAT_AreaAttackResolve, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AreaAttack Targets"), STAT_AreaAttackTargets, STATGROUP_Slash);
+
+void UAreaAttackSubsystem::Deinitialize()
+{
+	Overlaps.Empty();
+	PendingAttacks.Empty();
+	ResolvingAttacks.Empty();
+	Super::Deinitialize();
+}
+
+bool UAreaAttackSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UAreaAttackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAreaAttackSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Hits every hostile target in the area, nearest first up to the target cap. With bRequireLineOfSight the targets are only
+/// gathered here and hit on the next tick
+/// </summary>
+int32 UAreaAttackSubsystem::ApplyAreaAttack(AActor* Attacker, const FAreaAttack& Attack)
+{
+	FTargetArray Targets;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_AreaAttackQuery);
+		GatherTargets(Attacker, Attack, Targets);
+	}
+	INC_DWORD_STAT_BY(STAT_AreaAttackTargets, Targets.Num());
+	if (Targets.Num() == 0)
+	{
+		return 0;
+	}
+
+	if (!Attack.bRequireLineOfSight)
+	{
+		for (const FAreaTarget& Target : Targets)
+		{
+			ApplyToTarget(Attacker, Attack, Target);
+		}
+		return Targets.Num();
+	}
+
+	// Only world geometry blocks the blast, not other characters
+	UWorld* World = GetWorld();
+	const FCollisionObjectQueryParams Blockers(ECollisionChannel::ECC_WorldStatic);
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(AreaAttackLineOfSight), false, Attacker);
+	FPendingAreaAttack& Pending = PendingAttacks.AddDefaulted_GetRef();
+	Pending.Attacker = Attacker;
+	Pending.Attack = Attack;
+	Pending.Frame = GFrameCounter;
+	Pending.Targets.Reserve(Targets.Num());
+	for (FAreaTarget& Target : Targets)
+	{
+		Target.LineOfSight = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Attack.Origin, Target.Point, Blockers, Params);
+		Pending.Targets.Add(Target);
+	}
+	return Targets.Num();
+}
+
+/// <summary>
+/// Hits the targets of earlier frames' attacks that the blast can see
+/// </summary>
+void UAreaAttackSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AreaAttackResolve);
+	// In the order they were made, so the ones from earlier frames are at the front
+	const int32 NumReady = Algo::LowerBoundBy(PendingAttacks, GFrameCounter, &FPendingAreaAttack::Frame);
+	if (NumReady == 0)
+	{
+		return;
+	}
+
+	// Moved out first, a hit may start another area attack
+	ResolvingAttacks.Reset();
+	for (int32 Index = 0; Index < NumReady; ++Index)
+	{
+		ResolvingAttacks.Add(MoveTemp(PendingAttacks[Index]));
+	}
+	PendingAttacks.RemoveAt(0, NumReady, false);
+
+	UWorld* World = GetWorld();
+	for (const FPendingAreaAttack& Pending : ResolvingAttacks)
+	{
+		AActor* Attacker = Pending.Attacker.Get();
+		for (const FAreaTarget& Target : Pending.Targets)
+		{
+			const bool bBlocked = World->QueryTraceData(Target.LineOfSight, TraceData) && TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit;
+			if (!bBlocked)
+			{
+				ApplyToTarget(Attacker, Pending.Attack, Target);
+			}
+		}
+	}
+	ResolvingAttacks.Reset();
+}
+
+/// <summary>
+/// One overlap on the Hitbox channel, then one entry per actor at its nearest overlapped component, inside the shape,
+/// hostile to the attacker, sorted nearest first and capped
+/// </summary>
+void UAreaAttackSubsystem::GatherTargets(AActor* Attacker, const FAreaAttack& Attack, FTargetArray& OutTargets)
+{
+	const bool bCapsule = Attack.Shape == EAreaAttackShape::EAAS_Capsule;
+	const FVector Axis = Attack.Direction.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+	const FCollisionShape Shape = bCapsule ? FCollisionShape::MakeCapsule(Attack.Radius, Attack.HalfHeight) : FCollisionShape::MakeSphere(Attack.Radius);
+	const FQuat Rotation = bCapsule ? FRotationMatrix::MakeFromZ(Axis).ToQuat() : FQuat::Identity;
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(AreaAttack), false, Attacker);
+
+	Overlaps.Reset();
+	GetWorld()->OverlapMultiByChannel(Overlaps, Attack.Origin, Rotation, ECC_Hitbox, Shape, Params);
+
+	const FVector AxisOffset = Axis * FMath::Max(Attack.HalfHeight - Attack.Radius, 0.f);
+	const double CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(Attack.ConeHalfAngle));
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* Actor = Overlap.GetActor();
+		const UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Actor == nullptr || Component == nullptr || !UFactionComponent::CanDamage(Attacker, Actor))
+		{
+			continue;
+		}
+
+		const FVector Point = Component->Bounds.Origin;
+		const FVector ToPoint = Point - Attack.Origin;
+		if (Attack.Shape == EAreaAttackShape::EAAS_Cone && !ToPoint.IsNearlyZero() && (ToPoint.GetSafeNormal() | Axis) < CosHalfAngle)
+		{
+			continue;
+		}
+
+		const double DistanceSq = bCapsule
+			? FMath::Square(FMath::PointDistToSegment(Point, Attack.Origin - AxisOffset, Attack.Origin + AxisOffset))
+			: ToPoint.SizeSquared();
+		FAreaTarget* Existing = OutTargets.FindByPredicate([Actor](const FAreaTarget& Target) { return Target.Actor.Get() == Actor; });
+		if (Existing == nullptr)
+		{
+			Existing = &OutTargets.AddDefaulted_GetRef();
+			Existing->Actor = Actor;
+		}
+		else if (Existing->DistanceSq <= DistanceSq)
+		{
+			continue;
+		}
+		Existing->Point = Point;
+		Existing->DistanceSq = DistanceSq;
+	}
+
+	OutTargets.Sort([](const FAreaTarget& A, const FAreaTarget& B) { return A.DistanceSq < B.DistanceSq; });
+	const int32 MaxTargets = Attack.MaxTargets > 0 ? FMath::Min(Attack.MaxTargets, MaxTargetsPerAttack) : MaxTargetsPerAttack;
+	if (OutTargets.Num() > MaxTargets)
+	{
+		OutTargets.SetNum(MaxTargets, false);
+	}
+
+	for (FAreaTarget& Target : OutTargets)
+	{
+		const float Alpha = Attack.Radius > 0.f ? FMath::Clamp(FMath::Sqrt(Target.DistanceSq) / Attack.Radius, 0.f, 1.f) : 0.f;
+		Target.DamageScale = FMath::Lerp(1.f, Attack.EdgeDamageScale, Alpha);
+	}
+}
+
+/// <summary>
+/// Same contract as AWeapon: through the damage queue when there is one, otherwise GetHit then ApplyDamage.
+/// The hit comes from the attack's origin so hit reactions face the blast
+/// </summary>
+void UAreaAttackSubsystem::ApplyToTarget(AActor* Attacker, const FAreaAttack& Attack, const FAreaTarget& Target)
+{
+	AActor* Actor = Target.Actor.Get();
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	if (ABreakableActor* Breakable = Cast<ABreakableActor>(Actor))
+	{
+		Breakable->Shatter();
+	}
+
+	const APawn* AttackerPawn = Cast<APawn>(Attacker);
+	AController* InstigatorController = AttackerPawn ? AttackerPawn->GetController() : nullptr;
+	const float Damage = Attack.Damage * Target.DamageScale;
+	if (UDamageQueueSubsystem* DamageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
+	{
+		DamageQueue->QueueHit(Actor, Damage, Attack.Origin, Attacker, InstigatorController, Attacker);
+		return;
+	}
+
+	if (Actor->Implements<UHitInterface>())
+	{
+		IHitInterface::Execute_GetHit(Actor, Attack.Origin, Attacker);
+	}
+	UGameplayStatics::ApplyDamage(Actor, Damage, InstigatorController, Attacker, UDamageType::StaticClass());
+}
+
+/// <summary>
+/// Area attack centered on the player, for testing the shapes, falloff and target cap in a level.
+/// Usage: slash.AreaAttack.Test [Radius] [Damage] [Sphere|Cone|Capsule]
+/// </summary>
+static void TestAreaAttack(const TArray<FString>& Args, UWorld* World)
+{
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	UAreaAttackSubsystem* AreaAttacks = World ? World->GetSubsystem<UAreaAttackSubsystem>() : nullptr;
+	if (PlayerPawn == nullptr || AreaAttacks == nullptr)
+	{
+		return;
+	}
+
+	FAreaAttack Attack;
+	Attack.Radius = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 500.f;
+	Attack.Damage = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20.f;
+	if (Args.Num() > 2)
+	{
+		Attack.Shape = Args[2] == TEXT("Cone") ? EAreaAttackShape::EAAS_Cone : Args[2] == TEXT("Capsule") ? EAreaAttackShape::EAAS_Capsule : EAreaAttackShape::EAAS_Sphere;
+	}
+	Attack.Origin = PlayerPawn->GetActorLocation();
+	Attack.Direction = PlayerPawn->GetActorForwardVector();
+	Attack.HalfHeight = Attack.Radius * 2.f;
+	Attack.bRequireLineOfSight = true;
+
+	const int32 NumTargets = AreaAttacks->ApplyAreaAttack(PlayerPawn, Attack);
+	UE_LOG(LogTemp, Display, TEXT("AreaAttack: %d targets"), NumTargets);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TestAreaAttackCommand(
+	TEXT("slash.AreaAttack.Test"),
+	TEXT("Area attack around the player: slash.AreaAttack.Test [Radius] [Damage] [Sphere|Cone|Capsule]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&TestAreaAttack));
@@ -0,0 +1,121 @@
+#include "Combat/DamageQueueSubsystem.h"
+#include "Combat/WeaponTraceSubsystem.h"
+#include "Components/FactionComponent.h"
+#include "Interfaces/HitInterface.h"
+#include "Kismet/GameplayStatics.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("DamageQueue Resolve"), STAT_DamageQueueResolve, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DamageQueue Hits Queued"), STAT_DamageQueueHitsQueued, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DamageQueue Victims Per Frame"), STAT_DamageQueueVictims, STATGROUP_Slash);
+
+void UDamageQueueSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	WeaponTraces = Collection.InitializeDependency<UWeaponTraceSubsystem>();
+}
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	PendingHits.Empty();
+	ResolvingHits.Empty();
+	Victims.Empty();
+	VictimIndices.Empty();
+	Super::Deinitialize();
+}
+
+bool UDamageQueueSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Queues a hit for this frame's resolve. Replaces calling IHitInterface::GetHit and UGameplayStatics::ApplyDamage directly
+/// </summary>
+void UDamageQueueSubsystem::QueueHit(AActor* Victim, float Damage, const FVector& ImpactPoint, AActor* Hitter, AController* EventInstigator, AActor* DamageCauser)
+{
+	if (Victim == nullptr)
+	{
+		return;
+	}
+
+	FQueuedHit& Hit = PendingHits.AddDefaulted_GetRef();
+	Hit.Victim = Victim;
+	Hit.Hitter = Hitter;
+	Hit.EventInstigator = EventInstigator;
+	Hit.DamageCauser = DamageCauser;
+	Hit.ImpactPoint = ImpactPoint;
+	Hit.Damage = Damage;
+	INC_DWORD_STAT(STAT_DamageQueueHitsQueued);
+}
+
+/// <summary>
+/// Sums the frame's hits per victim, then for each victim in first hit order applies the damage once and plays one hit
+/// reaction from the first hit's impact point and hitter. Victims that were already dead when their turn came are skipped
+/// </summary>
+void UDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageQueueResolve);
+
+	// Tickables have no defined order, resolving the weapon traces here makes their hits land this frame either way
+	if (WeaponTraces)
+	{
+		WeaponTraces->ResolveReadyTraces();
+	}
+
+	if (PendingHits.Num() == 0)
+	{
+		SET_DWORD_STAT(STAT_DamageQueueVictims, 0);
+		return;
+	}
+
+	// Swapped out first, a death or hit reaction may queue more hits for the next frame
+	Swap(PendingHits, ResolvingHits);
+	PendingHits.Reset();
+
+	Victims.Reset();
+	VictimIndices.Reset();
+	for (int32 HitIndex = 0; HitIndex < ResolvingHits.Num(); ++HitIndex)
+	{
+		const FQueuedHit& Hit = ResolvingHits[HitIndex];
+		AActor* Victim = Hit.Victim.Get();
+		if (Victim == nullptr)
+		{
+			continue;
+		}
+
+		int32& VictimIndex = VictimIndices.FindOrAdd(Victim, INDEX_NONE);
+		if (VictimIndex == INDEX_NONE)
+		{
+			VictimIndex = Victims.Num();
+			Victims.AddDefaulted_GetRef().FirstHit = HitIndex;
+		}
+		Victims[VictimIndex].TotalDamage += Hit.Damage;
+	}
+	SET_DWORD_STAT(STAT_DamageQueueVictims, Victims.Num());
+
+	for (const FVictimDamage& VictimDamage : Victims)
+	{
+		const FQueuedHit& FirstHit = ResolvingHits[VictimDamage.FirstHit];
+		AActor* Victim = FirstHit.Victim.Get();
+		// Killed by an earlier frame's hits or something outside the queue, a corpse takes no damage and plays no reaction
+		if (!IsValid(Victim) || UFactionComponent::IsActorDead(Victim))
+		{
+			continue;
+		}
+
+		UGameplayStatics::ApplyDamage(Victim, VictimDamage.TotalDamage, FirstHit.EventInstigator.Get(), FirstHit.DamageCauser.Get(), UDamageType::StaticClass());
+
+		// The damage may have killed and pooled or destroyed the victim
+		if (IsValid(Victim) && Victim->Implements<UHitInterface>())
+		{
+			IHitInterface::Execute_GetHit(Victim, FirstHit.ImpactPoint, FirstHit.Hitter.Get());
+		}
+	}
+	ResolvingHits.Reset();
+}
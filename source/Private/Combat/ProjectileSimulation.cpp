@@ -0,0 +1,117 @@
+#include "Combat/ProjectileSimulation.h"
+#include "Math/VectorRegister.h"
+
+int32 FProjectileSimulation::Add(const FVector& Location, const FVector& Velocity, float Drag, float GravityScale, float Lifetime)
+{
+	const int32 Index = PositionX.Add(Location.X);
+	PositionY.Add(Location.Y);
+	PositionZ.Add(Location.Z);
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+	SweptX.Add(Location.X);
+	SweptY.Add(Location.Y);
+	SweptZ.Add(Location.Z);
+	Drags.Add(Drag);
+	GravityScales.Add(GravityScale);
+	TimesLeft.Add(Lifetime);
+	return Index;
+}
+
+void FProjectileSimulation::RemoveAtSwap(int32 Index)
+{
+	PositionX.RemoveAtSwap(Index, 1, false);
+	PositionY.RemoveAtSwap(Index, 1, false);
+	PositionZ.RemoveAtSwap(Index, 1, false);
+	VelocityX.RemoveAtSwap(Index, 1, false);
+	VelocityY.RemoveAtSwap(Index, 1, false);
+	VelocityZ.RemoveAtSwap(Index, 1, false);
+	SweptX.RemoveAtSwap(Index, 1, false);
+	SweptY.RemoveAtSwap(Index, 1, false);
+	SweptZ.RemoveAtSwap(Index, 1, false);
+	Drags.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	TimesLeft.RemoveAtSwap(Index, 1, false);
+}
+
+void FProjectileSimulation::Reset()
+{
+	PositionX.Reset();
+	PositionY.Reset();
+	PositionZ.Reset();
+	VelocityX.Reset();
+	VelocityY.Reset();
+	VelocityZ.Reset();
+	SweptX.Reset();
+	SweptY.Reset();
+	SweptZ.Reset();
+	Drags.Reset();
+	GravityScales.Reset();
+	TimesLeft.Reset();
+}
+
+void FProjectileSimulation::Reserve(int32 Number)
+{
+	PositionX.Reserve(Number);
+	PositionY.Reserve(Number);
+	PositionZ.Reserve(Number);
+	VelocityX.Reserve(Number);
+	VelocityY.Reserve(Number);
+	VelocityZ.Reserve(Number);
+	SweptX.Reserve(Number);
+	SweptY.Reserve(Number);
+	SweptZ.Reserve(Number);
+	Drags.Reserve(Number);
+	GravityScales.Reserve(Number);
+	TimesLeft.Reserve(Number);
+}
+
+void FProjectileSimulation::MarkSwept(int32 Index)
+{
+	SweptX[Index] = PositionX[Index];
+	SweptY[Index] = PositionY[Index];
+	SweptZ[Index] = PositionZ[Index];
+}
+
+/// <summary>
+/// Semi-implicit Euler: drag and gravity change the velocity first, then the new velocity moves the projectile.
+/// Four projectiles per iteration, the remainder one at a time with the same math
+/// </summary>
+void FProjectileSimulation::Integrate(float DeltaTime, float GravityZ)
+{
+	const int32 NumProjectiles = Num();
+	const int32 NumVectorized = NumProjectiles & ~3;
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+	const VectorRegister4Float Delta = VectorSetFloat1(DeltaTime);
+	const VectorRegister4Float GravityDelta = VectorSetFloat1(GravityZ * DeltaTime);
+
+	for (int32 Index = 0; Index < NumVectorized; Index += 4)
+	{
+		const VectorRegister4Float Damping = VectorMax(Zero, VectorNegateMultiplyAdd(VectorLoad(&Drags[Index]), Delta, One));
+		const VectorRegister4Float VelX = VectorMultiply(VectorLoad(&VelocityX[Index]), Damping);
+		const VectorRegister4Float VelY = VectorMultiply(VectorLoad(&VelocityY[Index]), Damping);
+		const VectorRegister4Float VelZ = VectorMultiplyAdd(VectorLoad(&GravityScales[Index]), GravityDelta, VectorMultiply(VectorLoad(&VelocityZ[Index]), Damping));
+
+		VectorStore(VelX, &VelocityX[Index]);
+		VectorStore(VelY, &VelocityY[Index]);
+		VectorStore(VelZ, &VelocityZ[Index]);
+		VectorStore(VectorMultiplyAdd(VelX, Delta, VectorLoad(&PositionX[Index])), &PositionX[Index]);
+		VectorStore(VectorMultiplyAdd(VelY, Delta, VectorLoad(&PositionY[Index])), &PositionY[Index]);
+		VectorStore(VectorMultiplyAdd(VelZ, Delta, VectorLoad(&PositionZ[Index])), &PositionZ[Index]);
+		VectorStore(VectorSubtract(VectorLoad(&TimesLeft[Index]), Delta), &TimesLeft[Index]);
+	}
+
+	for (int32 Index = NumVectorized; Index < NumProjectiles; ++Index)
+	{
+		const float Damping = FMath::Max(0.f, 1.f - Drags[Index] * DeltaTime);
+		VelocityX[Index] *= Damping;
+		VelocityY[Index] *= Damping;
+		VelocityZ[Index] = VelocityZ[Index] * Damping + GravityScales[Index] * GravityZ * DeltaTime;
+		PositionX[Index] += VelocityX[Index] * DeltaTime;
+		PositionY[Index] += VelocityY[Index] * DeltaTime;
+		PositionZ[Index] += VelocityZ[Index] * DeltaTime;
+		TimesLeft[Index] -= DeltaTime;
+	}
+}
@@ -0,0 +1,423 @@
+#include "Combat/ProjectileSubsystem.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Components/FactionComponent.h"
+#include "Components/HitboxComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Interfaces/HitInterface.h"
+#include "Kismet/GameplayStatics.h"
+#include "Slash/SlashCollision.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Resolve"), STAT_ProjectileResolve, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Projectile Integrate"), STAT_ProjectileIntegrate, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Projectile Sweeps"), STAT_ProjectileSweeps, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Projectile Instances"), STAT_ProjectileInstances, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Sweeps Per Frame"), STAT_ProjectileSweepsPerFrame, STATGROUP_Slash);
+
+void UProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Characters are only hit through their hitboxes, not their capsule or mesh
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_Destructible);
+	ObjectParams.AddObjectTypesToQuery(ECC_Hitbox);
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	ClearProjectiles();
+	InstanceTransforms.Empty();
+	Instances = nullptr;
+	InstanceHost = nullptr;
+	Super::Deinitialize();
+}
+
+bool UProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+void UProjectileSubsystem::Fire(AActor* Shooter, const FVector& Location, const FVector& Velocity, float Damage, float Drag, float GravityScale)
+{
+	Simulation.Add(Location, Velocity, Drag, GravityScale, Lifetime);
+	Shooters.Add(Shooter);
+	Damages.Add(Damage);
+}
+
+void UProjectileSubsystem::ClearProjectiles()
+{
+	Simulation.Reset();
+	Shooters.Reset();
+	Damages.Reset();
+	PendingSweeps.Reset();
+	SweepCursor = 0;
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_ProjectilesInFlight, Simulation.Num());
+	if (Simulation.Num() == 0 && InstanceTransforms.Num() == 0)
+	{
+		return;
+	}
+
+	const bool bBenchmarking = Benchmark.FramesLeft > 0;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileResolve);
+		if (bBenchmarking) Benchmark.Resolve.Begin();
+		ResolveSweeps();
+		RemoveExpired();
+		if (bBenchmarking) Benchmark.Resolve.End();
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileIntegrate);
+		if (bBenchmarking) Benchmark.Integrate.Begin();
+		Simulation.Integrate(DeltaTime, GetWorld()->GetGravityZ());
+		if (bBenchmarking) Benchmark.Integrate.End();
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileSweeps);
+		if (bBenchmarking) Benchmark.Sweeps.Begin();
+		IssueSweeps();
+		if (bBenchmarking) Benchmark.Sweeps.End();
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileInstances);
+		if (bBenchmarking) Benchmark.Instances.Begin();
+		UpdateInstances();
+		if (bBenchmarking) Benchmark.Instances.End();
+	}
+
+	if (bBenchmarking)
+	{
+		FinishBenchmarkFrame();
+	}
+}
+
+/// <summary>
+/// Reads last tick's sweeps from the highest index down, so removing a projectile only swaps in one that was already resolved
+/// or wasn't swept
+/// </summary>
+void UProjectileSubsystem::ResolveSweeps()
+{
+	UWorld* World = GetWorld();
+	for (int32 SweepIndex = PendingSweeps.Num() - 1; SweepIndex >= 0; --SweepIndex)
+	{
+		const FPendingSweep& Sweep = PendingSweeps[SweepIndex];
+		if (!World->QueryTraceData(Sweep.Handle, TraceData) || TraceData.OutHits.Num() == 0)
+		{
+			continue;
+		}
+
+		const FHitResult& Hit = TraceData.OutHits[0];
+		if (Hit.bBlockingHit)
+		{
+			ApplyHit(Sweep.Index, Hit);
+			RemoveProjectile(Sweep.Index);
+		}
+	}
+	PendingSweeps.Reset();
+}
+
+/// <summary>
+/// Anything hit stops the projectile, only hostile or faction-less actors are damaged
+/// </summary>
+void UProjectileSubsystem::ApplyHit(int32 Index, const FHitResult& Hit)
+{
+	AActor* HitActor = Hit.GetActor();
+	AActor* Shooter = Shooters[Index].Get();
+	if (HitActor == nullptr || !UFactionComponent::CanDamage(Shooter, HitActor))
+	{
+		return;
+	}
+
+	const APawn* ShooterPawn = Cast<APawn>(Shooter);
+	AController* InstigatorController = ShooterPawn ? ShooterPawn->GetController() : nullptr;
+	const float Damage = Damages[Index] * UHitboxComponent::GetDamageMultiplier(Hit);
+	if (UDamageQueueSubsystem* DamageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
+	{
+		DamageQueue->QueueHit(HitActor, Damage, Hit.ImpactPoint, Shooter, InstigatorController, Shooter);
+		return;
+	}
+
+	if (HitActor->Implements<UHitInterface>())
+	{
+		IHitInterface::Execute_GetHit(HitActor, Hit.ImpactPoint, Shooter);
+	}
+	UGameplayStatics::ApplyDamage(HitActor, Damage, InstigatorController, Shooter, UDamageType::StaticClass());
+}
+
+void UProjectileSubsystem::RemoveExpired()
+{
+	for (int32 Index = Simulation.Num() - 1; Index >= 0; --Index)
+	{
+		if (Simulation.TimesLeft[Index] <= 0.f)
+		{
+			RemoveProjectile(Index);
+		}
+	}
+}
+
+/// <summary>
+/// Sweeps up to MaxSweepsPerFrame projectiles round robin, each from where its last sweep ended.
+/// Projectiles left out this frame are swept over a longer segment next time
+/// </summary>
+void UProjectileSubsystem::IssueSweeps()
+{
+	const int32 NumProjectiles = Simulation.Num();
+	const int32 NumSweeps = FMath::Min(NumProjectiles, MaxSweepsPerFrame);
+	SET_DWORD_STAT(STAT_ProjectileSweepsPerFrame, NumSweeps);
+	if (NumSweeps == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(SweepRadius);
+	SweepCursor = SweepCursor % NumProjectiles;
+	PendingSweeps.Reserve(NumSweeps);
+	for (int32 Swept = 0; Swept < NumSweeps; ++Swept)
+	{
+		const int32 Index = (SweepCursor + Swept) % NumProjectiles;
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(ProjectileSweep), false, Shooters[Index].Get());
+
+		FPendingSweep& Sweep = PendingSweeps.AddDefaulted_GetRef();
+		Sweep.Index = Index;
+		Sweep.Handle = World->AsyncSweepByObjectType(EAsyncTraceType::Single, Simulation.GetSweptLocation(Index), Simulation.GetLocation(Index),
+			FQuat::Identity, ObjectParams, Shape, Params);
+		Simulation.MarkSwept(Index);
+	}
+	SweepCursor = (SweepCursor + NumSweeps) % NumProjectiles;
+
+	// Resolved from the highest index down
+	PendingSweeps.Sort([](const FPendingSweep& A, const FPendingSweep& B) { return A.Index < B.Index; });
+}
+
+void UProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	Simulation.RemoveAtSwap(Index);
+	Shooters.RemoveAtSwap(Index, 1, false);
+	Damages.RemoveAtSwap(Index, 1, false);
+}
+
+/// <summary>
+/// Moves the existing instances in one batch, facing along their projectile's velocity. Projectiles fired or removed since last
+/// frame only add or remove instances at the end, so the component is never cleared and rebuilt
+/// </summary>
+void UProjectileSubsystem::UpdateInstances()
+{
+	if (Instances == nullptr)
+	{
+		UStaticMesh* Mesh = InstanceMesh.LoadSynchronous();
+		if (Mesh == nullptr)
+		{
+			return;
+		}
+
+		InstanceHost = GetWorld()->SpawnActor<AActor>();
+		Instances = NewObject<UInstancedStaticMeshComponent>(InstanceHost);
+		Instances->SetStaticMesh(Mesh);
+		Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instances->SetCanEverAffectNavigation(false);
+		Instances->SetCastShadow(false);
+		InstanceHost->SetRootComponent(Instances);
+		Instances->RegisterComponent();
+	}
+
+	const int32 NumProjectiles = Simulation.Num();
+	const int32 NumInstances = Instances->GetInstanceCount();
+	const int32 NumKept = FMath::Min(NumProjectiles, NumInstances);
+
+	// Removing trailing instances never moves another one
+	if (NumInstances > NumProjectiles)
+	{
+		RemovedInstances.Reset();
+		for (int32 Index = NumInstances - 1; Index >= NumProjectiles; --Index)
+		{
+			RemovedInstances.Add(Index);
+		}
+		Instances->RemoveInstances(RemovedInstances);
+	}
+
+	InstanceTransforms.SetNum(NumKept, false);
+	AddedInstanceTransforms.SetNum(NumProjectiles - NumKept, false);
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		const FTransform Transform(Simulation.GetVelocity(Index).ToOrientationQuat(), Simulation.GetLocation(Index));
+		if (Index < NumKept)
+		{
+			InstanceTransforms[Index] = Transform;
+		}
+		else
+		{
+			AddedInstanceTransforms[Index - NumKept] = Transform;
+		}
+	}
+
+	if (NumKept > 0)
+	{
+		Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, false, true);
+	}
+	if (AddedInstanceTransforms.Num() > 0)
+	{
+		Instances->AddInstances(AddedInstanceTransforms, false, true);
+	}
+	// Sends the updated instance data without recreating the render state
+	Instances->MarkRenderInstancesDirty();
+}
+
+/// <summary>
+/// Times each stage of the next NumFrames ticks with MaxSweepsPerFrame set to SweepBudget, then logs them and restores the budget
+/// </summary>
+void UProjectileSubsystem::StartBenchmark(int32 NumFrames, int32 SweepBudget)
+{
+	const int32 SavedMaxSweepsPerFrame = Benchmark.FramesLeft > 0 ? Benchmark.SavedMaxSweepsPerFrame : MaxSweepsPerFrame;
+	Benchmark = FStageBenchmark();
+	Benchmark.FramesLeft = FMath::Max(NumFrames, 1);
+	Benchmark.SavedMaxSweepsPerFrame = SavedMaxSweepsPerFrame;
+	MaxSweepsPerFrame = FMath::Max(SweepBudget, 1);
+}
+
+void UProjectileSubsystem::FinishBenchmarkFrame()
+{
+	Benchmark.NumSweeps += PendingSweeps.Num();
+	Benchmark.NumProjectiles += Simulation.Num();
+	Benchmark.NumBudgetLimited += Simulation.Num() > MaxSweepsPerFrame ? 1 : 0;
+	if (--Benchmark.FramesLeft > 0)
+	{
+		return;
+	}
+
+	const int32 NumFrames = FMath::Max(Benchmark.Resolve.NumFrames, 1);
+	const double SweepsPerFrame = static_cast<double>(Benchmark.NumSweeps) / NumFrames;
+	const double ProjectilesPerFrame = static_cast<double>(Benchmark.NumProjectiles) / NumFrames;
+	UE_LOG(LogTemp, Display, TEXT("Projectile WorldBenchmark: %.0f projectiles, budget %d sweeps, %d frames"), ProjectilesPerFrame, MaxSweepsPerFrame, NumFrames);
+	UE_LOG(LogTemp, Display, TEXT("  ResolveSweeps: %s"), *Benchmark.Resolve.ToString());
+	UE_LOG(LogTemp, Display, TEXT("  Integrate: %s"), *Benchmark.Integrate.ToString());
+	UE_LOG(LogTemp, Display, TEXT("  IssueSweeps: %s"), *Benchmark.Sweeps.ToString());
+	UE_LOG(LogTemp, Display, TEXT("  UpdateInstances: %s"), *Benchmark.Instances.ToString());
+	UE_LOG(LogTemp, Display, TEXT("  %.0f sweeps per frame, %d frames limited by the budget, each projectile swept every %.2f frames"),
+		SweepsPerFrame, Benchmark.NumBudgetLimited, SweepsPerFrame > 0.0 ? ProjectilesPerFrame / SweepsPerFrame : 0.0);
+
+	MaxSweepsPerFrame = Benchmark.SavedMaxSweepsPerFrame;
+}
+
+/// <summary>
+/// Fires Count projectiles from the player in a forward cone, for testing ranged hits and the sweep budget in a level.
+/// Usage: slash.Projectile.Fire [Count] [Speed]
+/// </summary>
+static void FireTestProjectiles(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+	const float Speed = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 3000.f;
+
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	UProjectileSubsystem* Projectiles = World ? World->GetSubsystem<UProjectileSubsystem>() : nullptr;
+	if (PlayerPawn == nullptr || Projectiles == nullptr)
+	{
+		return;
+	}
+
+	const FVector Forward = PlayerPawn->GetActorForwardVector();
+	const FVector Start = PlayerPawn->GetActorLocation() + Forward * 100.0;
+	for (int32 Fired = 0; Fired < Count; ++Fired)
+	{
+		const FVector Direction = FMath::VRandCone(Forward + FVector(0.0, 0.0, 0.2), FMath::DegreesToRadians(20.f));
+		Projectiles->Fire(PlayerPawn, Start, Direction * Speed, 10.f, 0.1f);
+	}
+	UE_LOG(LogTemp, Display, TEXT("Projectile: %d in flight"), Projectiles->GetNumProjectiles());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs FireProjectilesCommand(
+	TEXT("slash.Projectile.Fire"),
+	TEXT("Fires projectiles from the player: slash.Projectile.Fire [Count] [Speed]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FireTestProjectiles));
+
+/// <summary>
+/// Integrates 5k and 20k projectiles and reads every projectile's sweep segment the way IssueSweeps does, counting the frames
+/// that go over the CPU budget 5k projectiles have to fit in
+/// </summary>
+static void RunProjectileBenchmark(int32 NumFrames)
+{
+	const double BudgetMs = 1.0;
+	const int32 ProjectileCounts[] = { 5000, 20000 };
+
+	for (const int32 NumProjectiles : ProjectileCounts)
+	{
+		FProjectileSimulation Bench;
+		Bench.Reserve(NumProjectiles);
+		FRandomStream Stream(NumProjectiles);
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			const FVector Location(Stream.FRandRange(-10000.f, 10000.f), Stream.FRandRange(-10000.f, 10000.f), 200.f);
+			Bench.Add(Location, Stream.GetUnitVector() * 3000.f, Stream.FRandRange(0.f, 0.5f), 1.f, NumFrames * SlashBenchmarkDeltaTime * 2.f);
+		}
+
+		FSlashBenchmarkTimer Timer(BudgetMs);
+		double SegmentLength = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Timer.Begin();
+			Bench.Integrate(SlashBenchmarkDeltaTime, -980.f);
+			for (int32 Index = 0; Index < NumProjectiles; ++Index)
+			{
+				SegmentLength += FVector::Dist(Bench.GetSweptLocation(Index), Bench.GetLocation(Index));
+				Bench.MarkSwept(Index);
+			}
+			Timer.End();
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Projectile Benchmark: %d projectiles, %d frames: %s, mean segment %.1f"),
+			NumProjectiles, NumFrames, *Timer.ToString(), SegmentLength / FMath::Max(NumFrames * NumProjectiles, 1));
+	}
+}
+
+static FSlashBenchmarkCommand ProjectileBenchmarkCommand(TEXT("Projectile"),
+	TEXT("Integrates FProjectileSimulation with 5k and 20k projectiles and reads their sweep segments"), &RunProjectileBenchmark);
+
+/// <summary>
+/// Fires Count projectiles in every direction from the player, or the world origin, and times each stage of the subsystem's
+/// tick over the next frames, including resolving the async sweeps, with the sweep budget set to SweepBudget.
+/// Usage: slash.Projectile.WorldBenchmark [Frames] [SweepBudget] [Count]
+/// </summary>
+static void RunProjectileWorldBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	UProjectileSubsystem* Projectiles = World ? World->GetSubsystem<UProjectileSubsystem>() : nullptr;
+	if (Projectiles == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 600;
+	const int32 SweepBudget = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 5000;
+	const int32 Count = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 5000;
+
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	const FVector Origin = PlayerPawn ? PlayerPawn->GetActorLocation() + FVector(0.0, 0.0, 200.0) : FVector::ZeroVector;
+
+	Projectiles->ClearProjectiles();
+	FRandomStream Stream(Count);
+	for (int32 Fired = 0; Fired < Count; ++Fired)
+	{
+		const FVector Direction = Stream.VRandCone(FVector::UpVector, FMath::DegreesToRadians(80.f));
+		Projectiles->Fire(PlayerPawn, Origin + Direction * 100.0, Direction * 3000.f, 0.f, 0.1f);
+	}
+	Projectiles->StartBenchmark(NumFrames, SweepBudget);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ProjectileWorldBenchmarkCommand(
+	TEXT("slash.Projectile.WorldBenchmark"),
+	TEXT("Times every stage of the projectile tick, async sweeps included, for a volley fired from the player. Usage: slash.Projectile.WorldBenchmark [Frames] [SweepBudget] [Count]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunProjectileWorldBenchmark));
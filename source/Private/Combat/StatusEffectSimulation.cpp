@@ -0,0 +1,194 @@
+#include "Combat/StatusEffectSimulation.h"
+
+int32 FStatusEffectSimulation::AllocateTarget()
+{
+	if (FreeTargets.Num() > 0)
+	{
+		return FreeTargets.Pop(false);
+	}
+
+	const int32 Target = TargetDamage.Add(0.f);
+	TargetStuns.Add(0);
+	TargetSlows.Add(1.f);
+	TargetEffectCounts.Add(0);
+	TargetChanged.Add(false);
+	return Target;
+}
+
+void FStatusEffectSimulation::FreeTarget(int32 Target)
+{
+	if (TargetEffectCounts[Target] > 0)
+	{
+		for (int32 Index = Num() - 1; Index >= 0; --Index)
+		{
+			if (Targets[Index] == Target)
+			{
+				RemoveAtSwap(Index);
+			}
+		}
+	}
+
+	TargetDamage[Target] = 0.f;
+	TargetStuns[Target] = 0;
+	TargetSlows[Target] = 1.f;
+	TargetEffectCounts[Target] = 0;
+	TargetChanged[Target] = false;
+	FreeTargets.Add(Target);
+}
+
+/// <summary>
+/// Starts an effect on the target. Stuns and slows take hold immediately, the first damage tick lands after one Period
+/// </summary>
+void FStatusEffectSimulation::Add(int32 Target, EStatusEffectType Type, float Magnitude, float Duration, float Period)
+{
+	Targets.Add(Target);
+	Types.Add(Type);
+	Magnitudes.Add(Magnitude);
+	Periods.Add(Period);
+	NextTicks.Add(Period);
+	TimesLeft.Add(Duration);
+
+	++TargetEffectCounts[Target];
+	if (Type == EStatusEffectType::ESE_Stun)
+	{
+		++TargetStuns[Target];
+	}
+	else if (Type == EStatusEffectType::ESE_Slow)
+	{
+		TargetSlows[Target] = FMath::Min(TargetSlows[Target], Magnitude);
+	}
+}
+
+/// <summary>
+/// Ticks every effect's damage into its target and removes the expired ones. Targets whose stun or slow changed go to
+/// ChangedTargets, targets left without effects to EmptiedTargets, and targets owed damage to DamagedTargets
+/// </summary>
+void FStatusEffectSimulation::Advance(float DeltaTime)
+{
+	for (const int32 Target : ChangedTargets)
+	{
+		TargetChanged[Target] = false;
+	}
+	DamagedTargets.Reset();
+	ChangedTargets.Reset();
+	EmptiedTargets.Reset();
+
+	bool bSlowExpired = false;
+
+	// Backwards, so the effect swapped into a removed one's place was already advanced
+	for (int32 Index = Num() - 1; Index >= 0; --Index)
+	{
+		const int32 Target = Targets[Index];
+		const EStatusEffectType Type = Types[Index];
+		const float TimeLeft = TimesLeft[Index] - DeltaTime;
+
+		if (Type == EStatusEffectType::ESE_Bleed || Type == EStatusEffectType::ESE_Poison)
+		{
+			// Both relative to the end of this frame, a tick lands if it is due and not after the expiry
+			float NextTick = NextTicks[Index] - DeltaTime;
+			while (NextTick <= 0.f && NextTick <= TimeLeft + UE_KINDA_SMALL_NUMBER)
+			{
+				if (TargetDamage[Target] == 0.f)
+				{
+					DamagedTargets.Add(Target);
+				}
+				TargetDamage[Target] += Magnitudes[Index];
+				NextTick += Periods[Index];
+			}
+			NextTicks[Index] = NextTick;
+		}
+
+		if (TimeLeft > 0.f)
+		{
+			TimesLeft[Index] = TimeLeft;
+			continue;
+		}
+
+		if (Type == EStatusEffectType::ESE_Stun && --TargetStuns[Target] == 0)
+		{
+			MarkChanged(Target);
+		}
+		else if (Type == EStatusEffectType::ESE_Slow)
+		{
+			MarkChanged(Target);
+			bSlowExpired = true;
+		}
+		if (--TargetEffectCounts[Target] == 0)
+		{
+			EmptiedTargets.Add(Target);
+		}
+		RemoveAtSwap(Index);
+	}
+
+	// One pass finds the strongest slow left on every target that lost one
+	if (bSlowExpired)
+	{
+		for (const int32 Target : ChangedTargets)
+		{
+			TargetSlows[Target] = 1.f;
+		}
+		for (int32 Index = 0; Index < Num(); ++Index)
+		{
+			const int32 Target = Targets[Index];
+			if (Types[Index] == EStatusEffectType::ESE_Slow && TargetChanged[Target])
+			{
+				TargetSlows[Target] = FMath::Min(TargetSlows[Target], Magnitudes[Index]);
+			}
+		}
+	}
+}
+
+float FStatusEffectSimulation::ConsumeDamage(int32 Target)
+{
+	const float Damage = TargetDamage[Target];
+	TargetDamage[Target] = 0.f;
+	return Damage;
+}
+
+void FStatusEffectSimulation::Reset()
+{
+	Targets.Reset();
+	Types.Reset();
+	Magnitudes.Reset();
+	Periods.Reset();
+	NextTicks.Reset();
+	TimesLeft.Reset();
+	TargetDamage.Reset();
+	TargetStuns.Reset();
+	TargetSlows.Reset();
+	TargetEffectCounts.Reset();
+	TargetChanged.Reset();
+	FreeTargets.Reset();
+	DamagedTargets.Reset();
+	ChangedTargets.Reset();
+	EmptiedTargets.Reset();
+}
+
+void FStatusEffectSimulation::Reserve(int32 NumEffects)
+{
+	Targets.Reserve(NumEffects);
+	Types.Reserve(NumEffects);
+	Magnitudes.Reserve(NumEffects);
+	Periods.Reserve(NumEffects);
+	NextTicks.Reserve(NumEffects);
+	TimesLeft.Reserve(NumEffects);
+}
+
+void FStatusEffectSimulation::RemoveAtSwap(int32 Index)
+{
+	Targets.RemoveAtSwap(Index, 1, false);
+	Types.RemoveAtSwap(Index, 1, false);
+	Magnitudes.RemoveAtSwap(Index, 1, false);
+	Periods.RemoveAtSwap(Index, 1, false);
+	NextTicks.RemoveAtSwap(Index, 1, false);
+	TimesLeft.RemoveAtSwap(Index, 1, false);
+}
+
+void FStatusEffectSimulation::MarkChanged(int32 Target)
+{
+	if (!TargetChanged[Target])
+	{
+		TargetChanged[Target] = true;
+		ChangedTargets.Add(Target);
+	}
+}
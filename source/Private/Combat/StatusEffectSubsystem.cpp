@@ -0,0 +1,244 @@
+#include "Combat/StatusEffectSubsystem.h"
+#include "Characters/BaseCharacter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Slash/SlashStats.h"
+#include "Slash/SlashBenchmark.h"
+
+DECLARE_CYCLE_STAT(TEXT("StatusEffects Advance"), STAT_StatusEffectsAdvance, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("StatusEffects Apply"), STAT_StatusEffectsApply, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("StatusEffects Active"), STAT_StatusEffectsActive, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("StatusEffects Damaged Targets"), STAT_StatusEffectsDamagedTargets, STATGROUP_Slash);
+
+void UStatusEffectSubsystem::Deinitialize()
+{
+	for (ABaseCharacter* Character : TargetCharacters)
+	{
+		if (Character)
+		{
+			Character->StatusEffectIndex = INDEX_NONE;
+		}
+	}
+	TargetCharacters.Empty();
+	Simulation.Reset();
+	PendingDamage.Empty();
+	Super::Deinitialize();
+}
+
+bool UStatusEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UStatusEffectSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UStatusEffectSubsystem, STATGROUP_Tickables);
+}
+
+void UStatusEffectSubsystem::ApplyEffect(ABaseCharacter* Target, EStatusEffectType Type, float Magnitude, float Duration, float Period)
+{
+	if (!IsValid(Target) || !Target->IsAlive() || Duration <= 0.f || Type >= EStatusEffectType::ESE_MAX)
+	{
+		return;
+	}
+
+	if (Target->StatusEffectIndex == INDEX_NONE)
+	{
+		const int32 Slot = Simulation.AllocateTarget();
+		if (Slot >= TargetCharacters.Num())
+		{
+			TargetCharacters.SetNumZeroed(Slot + 1);
+		}
+		TargetCharacters[Slot] = Target;
+		Target->StatusEffectIndex = Slot;
+	}
+
+	const int32 Slot = Target->StatusEffectIndex;
+	const bool bSlow = Type == EStatusEffectType::ESE_Slow;
+	Simulation.Add(Slot, Type, bSlow ? FMath::Clamp(Magnitude, MinSlowMultiplier, 1.f) : Magnitude, Duration, FMath::Max(Period, MinPeriod));
+	if (bSlow || Type == EStatusEffectType::ESE_Stun)
+	{
+		Target->SetStatusEffects(Simulation.IsStunned(Slot), Simulation.GetSlowMultiplier(Slot));
+	}
+}
+
+void UStatusEffectSubsystem::ClearEffects(ABaseCharacter* Target)
+{
+	if (Target == nullptr || !TargetCharacters.IsValidIndex(Target->StatusEffectIndex) || TargetCharacters[Target->StatusEffectIndex] != Target)
+	{
+		return;
+	}
+
+	const int32 Slot = Target->StatusEffectIndex;
+	Simulation.FreeTarget(Slot);
+	TargetCharacters[Slot] = nullptr;
+	Target->StatusEffectIndex = INDEX_NONE;
+	Target->SetStatusEffects(false, 1.f);
+}
+
+/// <summary>
+/// Advances every effect, pushes stun and slow changes, frees the targets with no effects left and then applies the
+/// frame's damage per target. Damage goes last since a death clears the victim's effects
+/// </summary>
+void UStatusEffectSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_StatusEffectsActive, Simulation.Num());
+	if (Simulation.Num() == 0)
+	{
+		SET_DWORD_STAT(STAT_StatusEffectsDamagedTargets, 0);
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffectsAdvance);
+		Simulation.Advance(DeltaTime);
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffectsApply);
+	for (const int32 Slot : Simulation.ChangedTargets)
+	{
+		if (ABaseCharacter* Character = TargetCharacters[Slot])
+		{
+			Character->SetStatusEffects(Simulation.IsStunned(Slot), Simulation.GetSlowMultiplier(Slot));
+		}
+	}
+
+	PendingDamage.Reset();
+	for (const int32 Slot : Simulation.DamagedTargets)
+	{
+		FPendingDamage& Pending = PendingDamage.AddDefaulted_GetRef();
+		Pending.Target = TargetCharacters[Slot];
+		Pending.Damage = Simulation.ConsumeDamage(Slot);
+	}
+	SET_DWORD_STAT(STAT_StatusEffectsDamagedTargets, PendingDamage.Num());
+
+	for (const int32 Slot : Simulation.EmptiedTargets)
+	{
+		if (ABaseCharacter* Character = TargetCharacters[Slot])
+		{
+			Character->StatusEffectIndex = INDEX_NONE;
+		}
+		TargetCharacters[Slot] = nullptr;
+		Simulation.FreeTarget(Slot);
+	}
+
+	for (const FPendingDamage& Pending : PendingDamage)
+	{
+		ABaseCharacter* Character = Pending.Target.Get();
+		if (IsValid(Character) && Character->IsAlive())
+		{
+			UGameplayStatics::ApplyDamage(Character, Pending.Damage, nullptr, nullptr, UDamageType::StaticClass());
+		}
+	}
+}
+
+/// <summary>
+/// Applies an effect to every enemy within Radius of the player.
+/// Usage: slash.StatusEffects.Apply [Bleed|Poison|Stun|Slow] [Magnitude] [Duration] [Radius]
+/// </summary>
+static void RunApplyStatusEffect(const TArray<FString>& Args, UWorld* World)
+{
+	UStatusEffectSubsystem* StatusEffects = World ? World->GetSubsystem<UStatusEffectSubsystem>() : nullptr;
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (StatusEffects == nullptr || PlayerController == nullptr || PlayerController->GetPawn() == nullptr)
+	{
+		return;
+	}
+
+	const FString TypeName = Args.Num() > 0 ? Args[0] : TEXT("Bleed");
+	EStatusEffectType Type = EStatusEffectType::ESE_Bleed;
+	if (TypeName.Equals(TEXT("Poison"), ESearchCase::IgnoreCase))
+	{
+		Type = EStatusEffectType::ESE_Poison;
+	}
+	else if (TypeName.Equals(TEXT("Stun"), ESearchCase::IgnoreCase))
+	{
+		Type = EStatusEffectType::ESE_Stun;
+	}
+	else if (TypeName.Equals(TEXT("Slow"), ESearchCase::IgnoreCase))
+	{
+		Type = EStatusEffectType::ESE_Slow;
+	}
+	const float Magnitude = Args.Num() > 1 ? FCString::Atof(*Args[1]) : (Type == EStatusEffectType::ESE_Slow ? 0.5f : 5.f);
+	const float Duration = Args.Num() > 2 ? FCString::Atof(*Args[2]) : 5.f;
+	const double Radius = Args.Num() > 3 ? FCString::Atod(*Args[3]) : 2000.0;
+
+	const FVector Origin = PlayerController->GetPawn()->GetActorLocation();
+	int32 NumApplied = 0;
+	for (TActorIterator<AEnemy> It(World); It; ++It)
+	{
+		if (FVector::DistSquared(It->GetActorLocation(), Origin) <= FMath::Square(Radius))
+		{
+			StatusEffects->ApplyEffect(*It, Type, Magnitude, Duration);
+			++NumApplied;
+		}
+	}
+	UE_LOG(LogTemp, Display, TEXT("StatusEffects: applied %s to %d enemies, %d effects active"), *TypeName, NumApplied, StatusEffects->GetNumEffects());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ApplyStatusEffectCommand(
+	TEXT("slash.StatusEffects.Apply"),
+	TEXT("Applies a status effect to the enemies around the player. Usage: slash.StatusEffects.Apply [Bleed|Poison|Stun|Slow] [Magnitude] [Duration] [Radius]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunApplyStatusEffect));
+
+/// <summary>
+/// Runs FStatusEffectSimulation without a world with every effect kept alive by re-adding the expired ones, and times
+/// the advance plus collecting the damage, the work the subsystem does before ApplyDamage
+/// </summary>
+static void RunStatusEffectBenchmark(int32 NumFrames)
+{
+	const double BudgetMs = 0.5;
+	const int32 EffectCounts[] = { 5000, 20000 };
+
+	for (const int32 NumEffects : EffectCounts)
+	{
+		// A few effects on each of many targets, like a horde fight
+		const int32 NumTargets = NumEffects / 4;
+		FStatusEffectSimulation Bench;
+		Bench.Reserve(NumEffects);
+		FRandomStream Stream(NumEffects);
+		for (int32 Target = 0; Target < NumTargets; ++Target)
+		{
+			Bench.AllocateTarget();
+		}
+
+		auto AddRandomEffect = [&Bench, &Stream, NumTargets]()
+		{
+			const EStatusEffectType Type = static_cast<EStatusEffectType>(Stream.RandRange(0, static_cast<int32>(EStatusEffectType::ESE_MAX) - 1));
+			const float Magnitude = Type == EStatusEffectType::ESE_Slow ? Stream.FRandRange(0.3f, 0.9f) : Stream.FRandRange(1.f, 10.f);
+			Bench.Add(Stream.RandRange(0, NumTargets - 1), Type, Magnitude, Stream.FRandRange(1.f, 8.f), Stream.FRandRange(0.25f, 1.f));
+		};
+		for (int32 Index = 0; Index < NumEffects; ++Index)
+		{
+			AddRandomEffect();
+		}
+
+		FSlashBenchmarkTimer Timer(BudgetMs);
+		int64 NumDamaged = 0;
+		double TotalDamage = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Timer.Begin();
+			Bench.Advance(SlashBenchmarkDeltaTime);
+			for (const int32 Target : Bench.DamagedTargets)
+			{
+				TotalDamage += Bench.ConsumeDamage(Target);
+			}
+			Timer.End();
+			NumDamaged += Bench.DamagedTargets.Num();
+
+			while (Bench.Num() < NumEffects)
+			{
+				AddRandomEffect();
+			}
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("StatusEffect Benchmark: %d effects on %d targets, %d frames: %s, %.1f damaged targets per frame, %.0f damage"),
+			NumEffects, NumTargets, NumFrames, *Timer.ToString(), static_cast<double>(NumDamaged) / NumFrames, TotalDamage);
+	}
+}
+
+static FSlashBenchmarkCommand StatusEffectBenchmarkCommand(TEXT("StatusEffects"), TEXT("Times FStatusEffectSimulation at 5k and 20k effects"), &RunStatusEffectBenchmark);
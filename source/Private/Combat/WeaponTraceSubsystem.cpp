@@ -0,0 +1,106 @@
+#include "Combat/WeaponTraceSubsystem.h"
+#include "Items/Weapon.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+#include "Slash/SlashCollision.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("WeaponTrace Resolve"), STAT_WeaponTraceResolve, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("WeaponTrace Traces Per Frame"), STAT_WeaponTraceTracesPerFrame, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("WeaponTrace Resolved"), STAT_WeaponTraceResolved, STATGROUP_Slash);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("WeaponTrace Resolve Latency Avg (ms)"), STAT_WeaponTraceLatencyAvg, STATGROUP_Slash);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("WeaponTrace Resolve Latency Max (ms)"), STAT_WeaponTraceLatencyMax, STATGROUP_Slash);
+
+void UWeaponTraceSubsystem::Deinitialize()
+{
+	Requests.Empty();
+	ResolvingRequests.Empty();
+	Super::Deinitialize();
+}
+
+bool UWeaponTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UWeaponTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWeaponTraceSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Starts an async sweep on the Hitbox channel for the weapon's swing. The hits are handed to AWeapon::ResolveTrace on the next frame
+/// </summary>
+void UWeaponTraceSubsystem::RequestSweep(AWeapon* Weapon, uint32 SwingId, EAsyncTraceType TraceType, const FVector& Start, const FVector& End, const FQuat& Rotation,
+	const FCollisionShape& Shape, const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams)
+{
+	FWeaponTraceRequest& Request = Requests.AddDefaulted_GetRef();
+	Request.Weapon = Weapon;
+	Request.WeaponId = Weapon->GetUniqueID();
+	Request.SwingId = SwingId;
+	Request.Sequence = NextSequence++;
+	Request.Frame = GFrameCounter;
+	Request.SubmitTime = FPlatformTime::Seconds();
+	Request.Handle = GetWorld()->AsyncSweepByChannel(TraceType, Start, End, Rotation, ECC_Hitbox, Shape, QueryParams, ResponseParams);
+	++NumRequestedThisFrame;
+}
+
+void UWeaponTraceSubsystem::Tick(float DeltaTime)
+{
+	ResolveReadyTraces();
+}
+
+/// <summary>
+/// Resolves every request from earlier frames, once per frame. Requests made this frame, by weapons ticking before this,
+/// wait for the next one. UDamageQueueSubsystem calls this before applying its hits so the hits found here land the same frame
+/// </summary>
+void UWeaponTraceSubsystem::ResolveReadyTraces()
+{
+	if (LastResolvedFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastResolvedFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_WeaponTraceResolve);
+	SET_DWORD_STAT(STAT_WeaponTraceTracesPerFrame, NumRequestedThisFrame);
+	NumRequestedThisFrame = 0;
+
+	const int32 NumReady = Algo::LowerBoundBy(Requests, GFrameCounter, &FWeaponTraceRequest::Frame);
+	SET_DWORD_STAT(STAT_WeaponTraceResolved, NumReady);
+	if (NumReady == 0)
+	{
+		return;
+	}
+
+	// Moved out first, resolving a hit may start new traces
+	ResolvingRequests.Reset();
+	ResolvingRequests.Append(Requests.GetData(), NumReady);
+	Requests.RemoveAt(0, NumReady, false);
+
+	// Weapon tick order isn't stable, the resolve order is
+	ResolvingRequests.Sort([](const FWeaponTraceRequest& A, const FWeaponTraceRequest& B)
+	{
+		return A.WeaponId != B.WeaponId ? A.WeaponId < B.WeaponId : A.Sequence < B.Sequence;
+	});
+
+	const double Now = FPlatformTime::Seconds();
+	double TotalLatency = 0.0;
+	double MaxLatency = 0.0;
+	UWorld* World = GetWorld();
+	for (const FWeaponTraceRequest& Request : ResolvingRequests)
+	{
+		const double Latency = Now - Request.SubmitTime;
+		TotalLatency += Latency;
+		MaxLatency = FMath::Max(MaxLatency, Latency);
+
+		AWeapon* Weapon = Request.Weapon.Get();
+		if (Weapon && World->QueryTraceData(Request.Handle, TraceData))
+		{
+			Weapon->ResolveTrace(Request.SwingId, TraceData.OutHits);
+		}
+	}
+
+	SET_FLOAT_STAT(STAT_WeaponTraceLatencyAvg, TotalLatency * 1000.0 / NumReady);
+	SET_FLOAT_STAT(STAT_WeaponTraceLatencyMax, MaxLatency * 1000.0);
+}
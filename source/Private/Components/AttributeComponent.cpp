@@ -1,44 +1,163 @@
 #include "Components/AttributeComponent.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 
 UAttributeComponent::UAttributeComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+/// <summary>
+/// Aggregates every attribute once the base values are loaded, so the getters are valid before BeginPlay
+/// </summary>
+void UAttributeComponent::OnRegister()
+{
+	Super::OnRegister();
+	for (int32 Attribute = 0; Attribute < static_cast<int32>(EModifiedAttribute::EMA_MAX); ++Attribute)
+	{
+		Aggregated[Attribute] = Aggregate(static_cast<EModifiedAttribute>(Attribute));
+	}
 }
 
 void UAttributeComponent::BeginPlay()
 {
-	CurrentHealth = MaxHealth;
+	SetHealth(GetMaxHealth());
+	StaminaTimestamp = GetTimeSeconds();
+	ScheduleStaminaFull();
+}
+
+/// <summary>
+/// Removes every modifier and restores full health and stamina, used when a pooled actor is reused
+/// </summary>
+void UAttributeComponent::ResetAttributes()
+{
+	ClearModifiers();
+	SetHealth(GetMaxHealth());
+	SetStamina(GetMaxStamina());
 }
 
 void UAttributeComponent::ChangeHealth(float Amount)
 {
-	CurrentHealth += Amount;
-	CurrentHealth = FMath::Clamp(CurrentHealth, 0, MaxHealth);
+	SetHealth(FMath::Clamp(CurrentHealth + Amount, 0.f, GetMaxHealth()));
 }
 
 void UAttributeComponent::ChangeGold(int32 Amount)
 {
-	Gold += Amount;
+	if (Amount != 0)
+	{
+		Gold += Amount;
+		OnGoldChanged.Broadcast(Gold);
+	}
 }
 
 void UAttributeComponent::ChangeSouls(int32 Amount)
 {
-	Souls += Amount;
+	if (Amount != 0)
+	{
+		Souls += Amount;
+		OnSoulsChanged.Broadcast(Souls);
+	}
 }
 
 void UAttributeComponent::UseStamina(float Amount)
 {
-	CurrentStamina = FMath::Clamp(CurrentStamina - Amount, 0.f, MaxStamina);
+	SetStamina(FMath::Clamp(GetStamina() - Amount, 0.f, GetMaxStamina()));
+}
+
+void UAttributeComponent::SetHealthPercent(float Percent)
+{
+	SetHealth(GetMaxHealth() * FMath::Clamp(Percent, 0.f, 1.f));
+}
+
+void UAttributeComponent::SetHealth(float NewHealth)
+{
+	if (NewHealth != CurrentHealth)
+	{
+		CurrentHealth = NewHealth;
+		OnHealthChanged.Broadcast(GetHealthPercent());
+	}
+}
+
+/// <summary>
+/// Restarts regeneration from NewStamina at the current time
+/// </summary>
+void UAttributeComponent::SetStamina(float NewStamina)
+{
+	const float OldStamina = GetStamina();
+	CurrentStamina = NewStamina;
+	StaminaTimestamp = GetTimeSeconds();
+	if (NewStamina != OldStamina)
+	{
+		OnStaminaChanged.Broadcast(GetStaminaPercent());
+	}
+	ScheduleStaminaFull();
+}
+
+/// <summary>
+/// Wakes up once when regeneration reaches MaxStamina, only while a listener is bound to OnStaminaChanged
+/// </summary>
+void UAttributeComponent::ScheduleStaminaFull()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	const float RechargeRate = GetStaminaRechargeRate();
+	if (!OnStaminaChanged.IsBound() || RechargeRate <= 0.f || CurrentStamina >= GetMaxStamina())
+	{
+		TimerManager.ClearTimer(StaminaFullTimer);
+		return;
+	}
+	TimerManager.SetTimer(StaminaFullTimer, this, &UAttributeComponent::OnStaminaFull, (GetMaxStamina() - CurrentStamina) / RechargeRate);
+}
+
+/// <summary>
+/// Rebases at MaxStamina and always broadcasts. Going through SetStamina wouldn't, GetStamina already reads the clamped max by now
+/// </summary>
+void UAttributeComponent::OnStaminaFull()
+{
+	CurrentStamina = GetMaxStamina();
+	StaminaTimestamp = GetTimeSeconds();
+	OnStaminaChanged.Broadcast(GetStaminaPercent());
+}
+
+double UAttributeComponent::GetTimeSeconds() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+float UAttributeComponent::EvaluateStaminaRegen(float Stamina, float Max, float RechargeRate, double Elapsed)
+{
+	if (Stamina >= Max)
+	{
+		return Stamina;
+	}
+	return FMath::Clamp(static_cast<float>(Stamina + RechargeRate * Elapsed), 0.f, Max);
+}
+
+float UAttributeComponent::GetStamina() const
+{
+	return EvaluateStaminaRegen(CurrentStamina, GetMaxStamina(), GetStaminaRechargeRate(), GetTimeSeconds() - StaminaTimestamp);
+}
+
+bool UAttributeComponent::CanUseDodge() const
+{
+	return GetStamina() >= GetDodgeCost();
 }
 
 float UAttributeComponent::GetHealthPercent()
 {
-	return CurrentHealth / MaxHealth;
+	return CurrentHealth / GetMaxHealth();
 }
 
-float UAttributeComponent::GetStaminaPercent()
+float UAttributeComponent::GetStaminaPercent() const
 {
-	return CurrentStamina / MaxStamina;
+	return GetStamina() / GetMaxStamina();
 }
 
 bool UAttributeComponent::IsAlive()
@@ -46,11 +165,199 @@ bool UAttributeComponent::IsAlive()
 	return CurrentHealth > 0;
 }
 
-void UAttributeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+/// <summary>
+/// Adds the modifier in priority order and aggregates its attribute again
+/// </summary>
+int32 UAttributeComponent::AddModifier(const FAttributeModifier& Modifier)
+{
+	if (Modifier.Attribute >= EModifiedAttribute::EMA_MAX)
+	{
+		return INDEX_NONE;
+	}
+
+	FActiveModifier Active;
+	Active.Modifier = Modifier;
+	Active.Id = NextModifierId++;
+	Modifiers.Insert(Active, Algo::UpperBoundBy(Modifiers, Modifier.Priority, [](const FActiveModifier& Entry) { return Entry.Modifier.Priority; }));
+
+	if (Modifier.Duration > 0.f)
+	{
+		FModifierExpiry Expiry;
+		Expiry.EndTime = GetTimeSeconds() + Modifier.Duration;
+		Expiry.Id = Active.Id;
+		Expiries.Insert(Expiry, Algo::UpperBoundBy(Expiries, Expiry.EndTime, &FModifierExpiry::EndTime));
+		ScheduleExpiry();
+	}
+
+	MarkDirty(Modifier.Attribute);
+	ApplyDirtyAttributes();
+	return Active.Id;
+}
+
+bool UAttributeComponent::RemoveModifier(int32 ModifierId)
+{
+	const int32 Index = Modifiers.IndexOfByPredicate([ModifierId](const FActiveModifier& Entry) { return Entry.Id == ModifierId; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 ExpiryIndex = Expiries.IndexOfByPredicate([ModifierId](const FModifierExpiry& Entry) { return Entry.Id == ModifierId; });
+	if (ExpiryIndex != INDEX_NONE)
+	{
+		Expiries.RemoveAt(ExpiryIndex, 1, false);
+		ScheduleExpiry();
+	}
+
+	RemoveModifierAt(Index);
+	ApplyDirtyAttributes();
+	return true;
+}
+
+void UAttributeComponent::ClearModifiers()
+{
+	while (Modifiers.Num() > 0)
+	{
+		RemoveModifierAt(Modifiers.Num() - 1);
+	}
+	Expiries.Reset();
+	ScheduleExpiry();
+	ApplyDirtyAttributes();
+}
+
+void UAttributeComponent::RemoveModifierAt(int32 Index)
+{
+	MarkDirty(Modifiers[Index].Modifier.Attribute);
+	Modifiers.RemoveAt(Index, 1, false);
+}
+
+/// <summary>
+/// Removes every modifier that has ended, in end time order, then aggregates the attributes they touched once
+/// </summary>
+void UAttributeComponent::ExpireModifiers()
+{
+	const int32 NumExpired = Algo::UpperBoundBy(Expiries, GetTimeSeconds(), &FModifierExpiry::EndTime);
+	for (int32 ExpiryIndex = 0; ExpiryIndex < NumExpired; ++ExpiryIndex)
+	{
+		const int32 Id = Expiries[ExpiryIndex].Id;
+		const int32 Index = Modifiers.IndexOfByPredicate([Id](const FActiveModifier& Entry) { return Entry.Id == Id; });
+		if (Index != INDEX_NONE)
+		{
+			RemoveModifierAt(Index);
+		}
+	}
+	Expiries.RemoveAt(0, NumExpired, false);
+	ScheduleExpiry();
+	ApplyDirtyAttributes();
+}
+
+void UAttributeComponent::ScheduleExpiry()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (Expiries.Num() == 0)
+	{
+		TimerManager.ClearTimer(ExpiryTimer);
+		return;
+	}
+	// A zero rate would clear the timer instead
+	const float Delay = FMath::Max(static_cast<float>(Expiries[0].EndTime - GetTimeSeconds()), UE_KINDA_SMALL_NUMBER);
+	TimerManager.SetTimer(ExpiryTimer, this, &UAttributeComponent::ExpireModifiers, Delay);
+}
+
+float UAttributeComponent::GetBaseValue(EModifiedAttribute Attribute) const
+{
+	switch (Attribute)
+	{
+	case EModifiedAttribute::EMA_MaxHealth:
+		return MaxHealth;
+	case EModifiedAttribute::EMA_MaxStamina:
+		return MaxStamina;
+	case EModifiedAttribute::EMA_StaminaRechargeRate:
+		return StaminaRechargeRate;
+	case EModifiedAttribute::EMA_DodgeStaminaCost:
+		return DodgeStaminaCost;
+	default:
+		return 0.f;
+	}
+}
+
+float UAttributeComponent::Aggregate(EModifiedAttribute Attribute) const
 {
-	if (CurrentStamina < MaxStamina)
+	float Value = GetBaseValue(Attribute);
+	for (const FActiveModifier& Active : Modifiers)
+	{
+		if (Active.Modifier.Attribute != Attribute)
+		{
+			continue;
+		}
+
+		switch (Active.Modifier.Op)
+		{
+		case EModifierOp::EMO_Add:
+			Value += Active.Modifier.Magnitude;
+			break;
+		case EModifierOp::EMO_Multiply:
+			Value *= Active.Modifier.Magnitude;
+			break;
+		case EModifierOp::EMO_Override:
+			Value = Active.Modifier.Magnitude;
+			break;
+		}
+	}
+	// Max health and stamina divide the percents
+	if (Attribute == EModifiedAttribute::EMA_MaxHealth || Attribute == EModifiedAttribute::EMA_MaxStamina)
+	{
+		Value = FMath::Max(Value, 1.f);
+	}
+	return FMath::Max(Value, 0.f);
+}
+
+void UAttributeComponent::MarkDirty(EModifiedAttribute Attribute)
+{
+	DirtyAttributes |= 1u << static_cast<uint32>(Attribute);
+}
+
+/// <summary>
+/// Aggregates the dirty attributes again. Health is clamped to a lower max, and stamina is rebased first so time
+/// already regenerated counts at the old rate
+/// </summary>
+void UAttributeComponent::ApplyDirtyAttributes()
+{
+	if (DirtyAttributes == 0)
+	{
+		return;
+	}
+
+	const float Stamina = GetStamina();
+	const float HealthPercent = GetHealthPercent();
+	const float StaminaPercent = GetStaminaPercent();
+
+	for (int32 Attribute = 0; Attribute < static_cast<int32>(EModifiedAttribute::EMA_MAX); ++Attribute)
+	{
+		if (DirtyAttributes & (1u << Attribute))
+		{
+			Aggregated[Attribute] = Aggregate(static_cast<EModifiedAttribute>(Attribute));
+		}
+	}
+	DirtyAttributes = 0;
+
+	CurrentHealth = FMath::Min(CurrentHealth, GetMaxHealth());
+	CurrentStamina = FMath::Min(Stamina, GetMaxStamina());
+	StaminaTimestamp = GetTimeSeconds();
+	ScheduleStaminaFull();
+
+	if (GetHealthPercent() != HealthPercent)
+	{
+		OnHealthChanged.Broadcast(GetHealthPercent());
+	}
+	if (GetStaminaPercent() != StaminaPercent)
 	{
-		UseStamina(-StaminaRechargeRate * DeltaTime);
+		OnStaminaChanged.Broadcast(GetStaminaPercent());
 	}
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 }
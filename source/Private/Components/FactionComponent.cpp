@@ -0,0 +1,79 @@
+#include "Components/FactionComponent.h"
+#include "Characters/BaseCharacter.h"
+
+UFactionComponent::UFactionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UFactionComponent::SetTeam(ETeam NewTeam)
+{
+	Team = NewTeam;
+	MirrorTag(FName("Enemy"), Team == ETeam::ET_Enemy);
+}
+
+void UFactionComponent::SetTargetable(bool bTargetable)
+{
+	Flags = bTargetable ? Flags | EFactionFlags::Targetable : Flags & ~EFactionFlags::Targetable;
+	MirrorTag(FName("EngageableTarget"), bTargetable);
+}
+
+void UFactionComponent::SetDead(bool bDead)
+{
+	Flags = bDead ? Flags | EFactionFlags::Dead : Flags & ~EFactionFlags::Dead;
+	MirrorTag(FName("Dead"), bDead);
+}
+
+/// <summary>
+/// Keeps the owner's tags matching the flags for Blueprints that still check them
+/// </summary>
+void UFactionComponent::MirrorTag(FName Tag, bool bHasTag)
+{
+	if (AActor* Owner = GetOwner())
+	{
+		if (bHasTag)
+		{
+			Owner->Tags.AddUnique(Tag);
+		}
+		else
+		{
+			Owner->Tags.Remove(Tag);
+		}
+	}
+}
+
+/// <summary>
+/// Characters keep their faction in a member, so the common case is a cast instead of a component search
+/// </summary>
+UFactionComponent* UFactionComponent::FindFaction(const AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+	if (const ABaseCharacter* Character = Cast<ABaseCharacter>(Actor))
+	{
+		return Character->GetFaction();
+	}
+	return Actor->FindComponentByClass<UFactionComponent>();
+}
+
+bool UFactionComponent::IsActorDead(const AActor* Actor)
+{
+	const UFactionComponent* Faction = FindFaction(Actor);
+	return Faction && Faction->IsDead();
+}
+
+/// <summary>
+/// Friendly fire check for weapons. Anything without a faction or team, like breakables, can always be hit
+/// </summary>
+bool UFactionComponent::CanDamage(const AActor* Attacker, const AActor* Victim)
+{
+	const UFactionComponent* AttackerFaction = FindFaction(Attacker);
+	const UFactionComponent* VictimFaction = FindFaction(Victim);
+	if (AttackerFaction == nullptr || VictimFaction == nullptr || AttackerFaction->Team == ETeam::ET_None || VictimFaction->Team == ETeam::ET_None)
+	{
+		return true;
+	}
+	return AttackerFaction->IsHostileTo(VictimFaction);
+}
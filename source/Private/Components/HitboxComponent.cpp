@@ -0,0 +1,321 @@
+#include "Components/HitboxComponent.h"
+#include "Characters/BaseCharacter.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "Slash/SlashCollision.h"
+#include "Slash/SlashStats.h"
+#include "EngineUtils.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitbox Shapes"), STAT_HitboxShapes, STATGROUP_Slash);
+
+UHitboxComponent::UHitboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Mannequin bones, children inherit the zone
+	BoneZones.Add(FName("neck_01"), EHitZone::EHZ_Head);
+	BoneZones.Add(FName("upperarm_l"), EHitZone::EHZ_Limb);
+	BoneZones.Add(FName("upperarm_r"), EHitZone::EHZ_Limb);
+	BoneZones.Add(FName("thigh_l"), EHitZone::EHZ_Limb);
+	BoneZones.Add(FName("thigh_r"), EHitZone::EHZ_Limb);
+
+	ZoneDamageMultipliers.Add(EHitZone::EHZ_Head, 1.5f);
+	ZoneDamageMultipliers.Add(EHitZone::EHZ_Limb, 0.75f);
+
+	for (float& Multiplier : ZoneMultipliers)
+	{
+		Multiplier = 1.f;
+	}
+}
+
+/// <summary>
+/// Builds the zone tables as soon as the component is registered, so damage multipliers are right for hits that land
+/// before BeginPlay
+/// </summary>
+void UHitboxComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	BuildZoneMultipliers();
+	if (USkeletalMeshComponent* Mesh = FindOwnerMesh())
+	{
+		BuildBoneZones(Mesh);
+	}
+}
+
+void UHitboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (USkeletalMeshComponent* Mesh = FindOwnerMesh())
+	{
+		CreateHitboxes(Mesh);
+	}
+}
+
+USkeletalMeshComponent* UHitboxComponent::FindOwnerMesh() const
+{
+	const AActor* Owner = GetOwner();
+	if (Owner == nullptr)
+	{
+		return nullptr;
+	}
+	const ACharacter* Character = Cast<ACharacter>(Owner);
+	return Character ? Character->GetMesh() : Owner->FindComponentByClass<USkeletalMeshComponent>();
+}
+
+void UHitboxComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_HitboxShapes, Hitboxes.Num());
+	for (UShapeComponent* Hitbox : Hitboxes)
+	{
+		if (Hitbox)
+		{
+			Hitbox->DestroyComponent();
+		}
+	}
+	Hitboxes.Empty();
+	HitboxBones.Empty();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHitboxComponent::SetHitboxesEnabled(bool bEnabled)
+{
+	for (UShapeComponent* Hitbox : Hitboxes)
+	{
+		Hitbox->SetCollisionEnabled(bEnabled ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+	}
+}
+
+/// <summary>
+/// Zone of a weapon hit, either on one of the hitboxes or on a bone of the mesh itself
+/// </summary>
+EHitZone UHitboxComponent::GetZone(const FHitResult& Hit) const
+{
+	int32 BoneIndex = INDEX_NONE;
+	const int32 HitboxIndex = Hitboxes.IndexOfByKey(Hit.GetComponent());
+	if (HitboxIndex != INDEX_NONE)
+	{
+		BoneIndex = HitboxBones[HitboxIndex];
+	}
+	else if (Hit.BoneName != NAME_None && ZoneMesh.IsValid())
+	{
+		BoneIndex = ZoneMesh->GetBoneIndex(Hit.BoneName);
+	}
+	return BoneToZone.IsValidIndex(BoneIndex) ? BoneToZone[BoneIndex] : EHitZone::EHZ_Body;
+}
+
+/// <summary>
+/// Damage scale for a weapon hit, 1 for actors without hitboxes
+/// </summary>
+float UHitboxComponent::GetDamageMultiplier(const FHitResult& Hit)
+{
+	const AActor* Actor = Hit.GetActor();
+	if (Actor == nullptr)
+	{
+		return 1.f;
+	}
+	const ABaseCharacter* Character = Cast<ABaseCharacter>(Actor);
+	const UHitboxComponent* HitboxComponent = Character ? Character->GetHitboxes() : Actor->FindComponentByClass<UHitboxComponent>();
+	return HitboxComponent ? HitboxComponent->GetZoneMultiplier(HitboxComponent->GetZone(Hit)) : 1.f;
+}
+
+/// <summary>
+/// Bones are stored parents first, so one pass gives every bone its own zone or its nearest mapped parent's
+/// </summary>
+void UHitboxComponent::BuildBoneZones(USkeletalMeshComponent* Mesh)
+{
+	ZoneMesh = Mesh;
+	BoneToZone.Reset();
+
+	const USkeletalMesh* SkeletalMesh = Mesh->GetSkeletalMeshAsset();
+	if (SkeletalMesh == nullptr)
+	{
+		return;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+	const int32 NumBones = RefSkeleton.GetNum();
+	BoneToZone.SetNumUninitialized(NumBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		if (const EHitZone* Zone = BoneZones.Find(RefSkeleton.GetBoneName(BoneIndex)))
+		{
+			BoneToZone[BoneIndex] = *Zone;
+			continue;
+		}
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		BoneToZone[BoneIndex] = ParentIndex != INDEX_NONE ? BoneToZone[ParentIndex] : EHitZone::EHZ_Body;
+	}
+}
+
+void UHitboxComponent::BuildZoneMultipliers()
+{
+	for (int32 Zone = 0; Zone < static_cast<int32>(EHitZone::EHZ_MAX); ++Zone)
+	{
+		const float* Multiplier = ZoneDamageMultipliers.Find(static_cast<EHitZone>(Zone));
+		ZoneMultipliers[Zone] = Multiplier ? *Multiplier : 1.f;
+	}
+}
+
+/// <summary>
+/// Uses Shapes when set, otherwise one shape per body of the physics asset from its first capsule, box or sphere
+/// </summary>
+void UHitboxComponent::CreateHitboxes(USkeletalMeshComponent* Mesh)
+{
+	if (Shapes.Num() > 0)
+	{
+		for (const FHitboxShape& Shape : Shapes)
+		{
+			AddHitbox(Mesh, Shape);
+		}
+		return;
+	}
+
+	const UPhysicsAsset* PhysicsAsset = Mesh->GetPhysicsAsset();
+	if (PhysicsAsset == nullptr)
+	{
+		return;
+	}
+
+	for (const USkeletalBodySetup* Body : PhysicsAsset->SkeletalBodySetups)
+	{
+		if (Body == nullptr)
+		{
+			continue;
+		}
+
+		FHitboxShape Shape;
+		Shape.Bone = Body->BoneName;
+		const FKAggregateGeom& Geometry = Body->AggGeom;
+		if (Geometry.SphylElems.Num() > 0)
+		{
+			const FKSphylElem& Capsule = Geometry.SphylElems[0];
+			Shape.Offset = Capsule.Center;
+			Shape.Rotation = Capsule.Rotation;
+			Shape.Radius = Capsule.Radius;
+			Shape.HalfHeight = Capsule.Length * 0.5f + Capsule.Radius;
+		}
+		else if (Geometry.BoxElems.Num() > 0)
+		{
+			const FKBoxElem& Box = Geometry.BoxElems[0];
+			Shape.Offset = Box.Center;
+			Shape.Rotation = Box.Rotation;
+			Shape.BoxExtent = FVector(Box.X, Box.Y, Box.Z) * 0.5f;
+		}
+		else if (Geometry.SphereElems.Num() > 0)
+		{
+			const FKSphereElem& Sphere = Geometry.SphereElems[0];
+			Shape.Offset = Sphere.Center;
+			Shape.Radius = Sphere.Radius;
+			Shape.HalfHeight = Sphere.Radius;
+		}
+		else
+		{
+			continue;
+		}
+		AddHitbox(Mesh, Shape);
+	}
+}
+
+/// <summary>
+/// Query only, no overlap events, and only the Hitbox channel, so the shape costs nothing to move beyond its transform
+/// </summary>
+void UHitboxComponent::AddHitbox(USkeletalMeshComponent* Mesh, const FHitboxShape& Shape)
+{
+	const int32 BoneIndex = Mesh->GetBoneIndex(Shape.Bone);
+	if (BoneIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	UShapeComponent* Hitbox = nullptr;
+	if (!Shape.BoxExtent.IsNearlyZero())
+	{
+		UBoxComponent* Box = NewObject<UBoxComponent>(GetOwner(), NAME_None, RF_Transient);
+		Box->SetBoxExtent(Shape.BoxExtent, false);
+		Hitbox = Box;
+	}
+	else
+	{
+		UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(GetOwner(), NAME_None, RF_Transient);
+		Capsule->SetCapsuleSize(Shape.Radius, FMath::Max(Shape.HalfHeight, Shape.Radius), false);
+		Hitbox = Capsule;
+	}
+
+	Hitbox->SetupAttachment(Mesh, Shape.Bone);
+	Hitbox->SetRelativeLocationAndRotation(Shape.Offset, Shape.Rotation);
+	Hitbox->SetGenerateOverlapEvents(false);
+	Hitbox->SetCanEverAffectNavigation(false);
+	Hitbox->CanCharacterStepUpOn = ECB_No;
+	Hitbox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Hitbox->SetCollisionObjectType(ECC_Hitbox);
+	Hitbox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+	Hitbox->SetCollisionResponseToChannel(ECC_Hitbox, ECollisionResponse::ECR_Block);
+	Hitbox->RegisterComponent();
+
+	Hitboxes.Add(Hitbox);
+	HitboxBones.Add(BoneIndex);
+	INC_DWORD_STAT(STAT_HitboxShapes);
+}
+
+/// <summary>
+/// Moves every character in the world back and forth, first with their meshes generating overlap events as they did before
+/// the hitboxes, then without as they do now, and logs the time each took.
+/// Usage: slash.Hitbox.OverlapCost [Moves]
+/// </summary>
+static void RunHitboxOverlapCost(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumMoves = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+	TArray<ABaseCharacter*> Characters;
+	for (TActorIterator<ABaseCharacter> It(World); It; ++It)
+	{
+		Characters.Add(*It);
+	}
+	if (Characters.Num() == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Hitbox OverlapCost: no characters in the world"));
+		return;
+	}
+
+	auto TimeMoves = [&Characters, NumMoves](bool bMeshOverlaps)
+	{
+		TArray<bool> WasGenerating;
+		for (ABaseCharacter* Character : Characters)
+		{
+			WasGenerating.Add(Character->GetMesh()->GetGenerateOverlapEvents());
+			Character->GetMesh()->SetGenerateOverlapEvents(bMeshOverlaps);
+		}
+
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Move = 0; Move < NumMoves; ++Move)
+		{
+			const FVector Offset(Move % 2 == 0 ? 1.0 : -1.0, 0.0, 0.0);
+			for (ABaseCharacter* Character : Characters)
+			{
+				Character->AddActorWorldOffset(Offset);
+			}
+		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+		for (int32 Index = 0; Index < Characters.Num(); ++Index)
+		{
+			Characters[Index]->GetMesh()->SetGenerateOverlapEvents(WasGenerating[Index]);
+		}
+		return ElapsedMs;
+	};
+
+	const double MeshOverlapsMs = TimeMoves(true);
+	const double HitboxesMs = TimeMoves(false);
+	UE_LOG(LogTemp, Display, TEXT("Hitbox OverlapCost: %d characters, %d moves each: mesh overlap events %.3f ms (%.4f ms per move), hitboxes only %.3f ms (%.4f ms per move)"),
+		Characters.Num(), NumMoves, MeshOverlapsMs, MeshOverlapsMs / (NumMoves * Characters.Num()), HitboxesMs, HitboxesMs / (NumMoves * Characters.Num()));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HitboxOverlapCostCommand(
+	TEXT("slash.Hitbox.OverlapCost"),
+	TEXT("Times moving every character with and without mesh overlap events. Usage: slash.Hitbox.OverlapCost [Moves]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHitboxOverlapCost));
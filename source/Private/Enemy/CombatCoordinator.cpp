@@ -0,0 +1,211 @@
+#include "Enemy/CombatCoordinator.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("CombatCoordinator Tokens Granted"), STAT_CombatCoordinatorTokensGranted, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("CombatCoordinator Tokens Denied"), STAT_CombatCoordinatorTokensDenied, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("CombatCoordinator Waiters Woken"), STAT_CombatCoordinatorWaitersWoken, STATGROUP_Slash);
+
+void UCombatCoordinator::Deinitialize()
+{
+	Targets.Empty();
+	EnemyTargets.Empty();
+	Super::Deinitialize();
+}
+
+bool UCombatCoordinator::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+/// <summary>
+/// Gives the enemy one of the target's attack tokens, or puts it in line for the next free one
+/// </summary>
+/// <returns>True if the enemy holds a token and may start its attack</returns>
+bool UCombatCoordinator::RequestAttackToken(AEnemy* Enemy, AActor* Target)
+{
+	if (Enemy == nullptr || Target == nullptr)
+	{
+		return false;
+	}
+
+	FCombatTargetSlots& Slots = AssignTarget(Enemy, Target);
+	if (Slots.TokenHolders.Contains(Enemy))
+	{
+		return true;
+	}
+
+	if (Slots.TokenHolders.Num() < FMath::Max(MaxAttackTokens, 1))
+	{
+		Slots.TokenHolders.Add(Enemy);
+		Slots.Waiters.RemoveSingle(Enemy);
+		INC_DWORD_STAT(STAT_CombatCoordinatorTokensGranted);
+		return true;
+	}
+
+	Slots.Waiters.AddUnique(Enemy);
+	INC_DWORD_STAT(STAT_CombatCoordinatorTokensDenied);
+	return false;
+}
+
+/// <summary>
+/// Returns the enemy's token after its attack, the enemy keeps its engagement slot
+/// </summary>
+void UCombatCoordinator::ReleaseAttackToken(AEnemy* Enemy)
+{
+	FCombatTargetSlots* Slots = FindSlots(Enemy);
+	if (Slots && Slots->TokenHolders.RemoveSingleSwap(Enemy, false) > 0)
+	{
+		WakeNextWaiter(EnemyTargets.FindChecked(Enemy));
+	}
+}
+
+/// <summary>
+/// Reserves a position on a ring of NumEngagementSlots around the target, preferring the one nearest the enemy
+/// </summary>
+/// <returns>False when every slot is taken</returns>
+bool UCombatCoordinator::ClaimEngagementSlot(AEnemy* Enemy, AActor* Target, double Radius, FVector& OutLocation)
+{
+	if (Enemy == nullptr || Target == nullptr)
+	{
+		return false;
+	}
+
+	FCombatTargetSlots& Slots = AssignTarget(Enemy, Target);
+	const int32 NumSlots = Slots.SlotHolders.Num();
+	const float SlotAngle = 360.f / NumSlots;
+	const FVector TargetLocation = Target->GetActorLocation();
+
+	int32 SlotIndex = Slots.SlotHolders.Find(Enemy);
+	if (SlotIndex == INDEX_NONE)
+	{
+		// Search outwards from the slot facing the enemy so nobody has to walk around the target
+		const float Bearing = (Enemy->GetActorLocation() - TargetLocation).Rotation().Yaw;
+		const int32 Preferred = FMath::RoundToInt(Bearing / SlotAngle);
+		for (int32 Step = 0; Step < NumSlots && SlotIndex == INDEX_NONE; ++Step)
+		{
+			const int32 Offset = (Step + 1) / 2 * (Step % 2 == 0 ? 1 : -1);
+			const int32 Candidate = ((Preferred + Offset) % NumSlots + NumSlots) % NumSlots;
+			if (Slots.SlotHolders[Candidate] == nullptr)
+			{
+				SlotIndex = Candidate;
+			}
+		}
+		if (SlotIndex == INDEX_NONE)
+		{
+			return false;
+		}
+		Slots.SlotHolders[SlotIndex] = Enemy;
+	}
+
+	OutLocation = TargetLocation + FRotator(0.f, SlotIndex * SlotAngle, 0.f).Vector() * Radius;
+	return true;
+}
+
+/// <summary>
+/// Drops the enemy's token, slot and place in line. Called whenever the enemy stops fighting its target
+/// </summary>
+void UCombatCoordinator::ReleaseEnemy(AEnemy* Enemy)
+{
+	AActor* Target = nullptr;
+	if (!EnemyTargets.RemoveAndCopyValue(Enemy, Target))
+	{
+		return;
+	}
+
+	FCombatTargetSlots* Slots = Targets.Find(Target);
+	if (Slots == nullptr)
+	{
+		return;
+	}
+
+	const bool bHadToken = Slots->TokenHolders.RemoveSingleSwap(Enemy, false) > 0;
+	Slots->Waiters.RemoveSingle(Enemy);
+	const int32 SlotIndex = Slots->SlotHolders.Find(Enemy);
+	if (SlotIndex != INDEX_NONE)
+	{
+		Slots->SlotHolders[SlotIndex] = nullptr;
+	}
+
+	if (bHadToken)
+	{
+		WakeNextWaiter(Target);
+	}
+	RemoveIfUnused(Target);
+}
+
+int32 UCombatCoordinator::GetNumTokenHolders(AActor* Target) const
+{
+	const FCombatTargetSlots* Slots = Targets.Find(Target);
+	return Slots ? Slots->TokenHolders.Num() : 0;
+}
+
+int32 UCombatCoordinator::GetNumWaiters(AActor* Target) const
+{
+	const FCombatTargetSlots* Slots = Targets.Find(Target);
+	return Slots ? Slots->Waiters.Num() : 0;
+}
+
+FCombatTargetSlots* UCombatCoordinator::FindSlots(AEnemy* Enemy)
+{
+	AActor** Target = EnemyTargets.Find(Enemy);
+	return Target ? Targets.Find(*Target) : nullptr;
+}
+
+/// <summary>
+/// An enemy only fights one target at a time, switching targets gives up everything held for the old one
+/// </summary>
+FCombatTargetSlots& UCombatCoordinator::AssignTarget(AEnemy* Enemy, AActor* Target)
+{
+	AActor** CurrentTarget = EnemyTargets.Find(Enemy);
+	if (CurrentTarget && *CurrentTarget != Target)
+	{
+		ReleaseEnemy(Enemy);
+	}
+	EnemyTargets.Add(Enemy, Target);
+
+	FCombatTargetSlots& Slots = Targets.FindOrAdd(Target);
+	if (Slots.SlotHolders.Num() == 0)
+	{
+		Slots.SlotHolders.Init(nullptr, FMath::Max(NumEngagementSlots, 1));
+	}
+	return Slots;
+}
+
+/// <summary>
+/// Offers free tokens to the longest waiting enemies. Each one re-runs its combat decision and takes the token
+/// if it is still in range, so only the enemies that can actually attack do any work
+/// </summary>
+void UCombatCoordinator::WakeNextWaiter(AActor* Target)
+{
+	FCombatTargetSlots* Slots = Targets.Find(Target);
+	while (Slots && Slots->Waiters.Num() > 0 && Slots->TokenHolders.Num() < FMath::Max(MaxAttackTokens, 1))
+	{
+		AEnemy* Waiter = Slots->Waiters[0];
+		if (!IsValid(Waiter) || Waiter->EnemyState != EEnemyState::EES_Waiting)
+		{
+			Slots->Waiters.RemoveAt(0, 1, false);
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_CombatCoordinatorWaitersWoken);
+		Waiter->HandleEnemyEvent(EEnemyEvent::EEE_AttackTokenReleased);
+
+		// The waiter may have released or switched targets, which can reallocate the map
+		Slots = Targets.Find(Target);
+		if (Slots && Slots->Waiters.Num() > 0 && Slots->Waiters[0] == Waiter)
+		{
+			break;
+		}
+	}
+}
+
+void UCombatCoordinator::RemoveIfUnused(AActor* Target)
+{
+	const FCombatTargetSlots* Slots = Targets.Find(Target);
+	if (Slots && Slots->TokenHolders.Num() == 0 && Slots->Waiters.Num() == 0 && !Slots->SlotHolders.ContainsByPredicate([](const AEnemy* Holder) { return Holder != nullptr; }))
+	{
+		Targets.Remove(Target);
+	}
+}
@@ -3,16 +3,27 @@
 
 #include "Enemy/Enemy.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Perception/PawnSensingComponent.h"
 #include "Animation/AnimInstance.h"
 #include "AIController.h"
 #include "Items/Weapon.h"
 #include "Kismet/GameplayStatics.h"
-#include "HUD/HealthBarComponent.h"
+#include "HUD/HealthBarSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "NavigationPath.h"
 #include "Components/AttributeComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/FactionComponent.h"
+#include "Components/HitboxComponent.h"
+#include "Enemy/CombatCoordinator.h"
+#include "Enemy/EnemyAIManager.h"
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "Enemy/PatrolPathCache.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Spatial/SpatialHashSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 AEnemy::AEnemy()
 {
@@ -20,41 +31,56 @@ AEnemy::AEnemy()
 	GetMesh()->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
-	GetMesh()->SetGenerateOverlapEvents(true);
+	// Weapons hit the bone driven hitboxes instead
+	GetMesh()->SetCollisionResponseToChannel(ECC_Hitbox, ECollisionResponse::ECR_Ignore);
+	GetMesh()->SetGenerateOverlapEvents(false);
 
-	HealthBarWidget = CreateDefaultSubobject<UHealthBarComponent>(TEXT("HealthBar"));
-	HealthBarWidget->SetupAttachment(GetRootComponent());
-
-
-	PawnSensor = CreateDefaultSubobject<UPawnSensingComponent>(TEXT("PawnSensor"));
-	PawnSensor->SetPeripheralVisionAngle(45.f);
-	PawnSensor->SightRadius = 4000.f;
 
 	GetCharacterMovement()->bOrientRotationToMovement = true;
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationRoll = false;
 	bUseControllerRotationYaw = false;
+
+	// Enemies spawned by waves and the actor pool need a controller too
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
 }
 
 void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (HealthBarWidget)
-	{
-		HealthBarWidget->SetHealthPercent(1.f);
-		ToggleHealthBar(false);
-	}
-
 	AIController = Cast<AAIController>(GetController());
-	
-	if (PawnSensor)
-	{
-		PawnSensor->OnSeePawn.AddDynamic(this, &AEnemy::OnPawnSeen);
-	}
 
 	SpawnDefaultWeapon();
+	StartBehavior();
+}
 
+/// <summary>
+/// Leaves the world subsystems and hands the weapon back to the pool. When the whole world is torn down the pool goes with it,
+/// so the weapon is left to be cleaned up with everything else
+/// </summary>
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopBehavior();
+	if (EquippedItem && EndPlayReason != EEndPlayReason::EndPlayInEditor && EndPlayReason != EEndPlayReason::Quit)
+	{
+		UWorld* World = GetWorld();
+		UActorPoolSubsystem* Pool = World ? World->GetSubsystem<UActorPoolSubsystem>() : nullptr;
+		if (Pool)
+		{
+			Pool->ReleaseActor(EquippedItem);
+		}
+		else
+		{
+			EquippedItem->Destroy();
+		}
+		EquippedItem = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy::StartBehavior()
+{
 	GetPatrolTarget();
 	if (PatrolTarget)
 	{
@@ -62,47 +88,282 @@ void AEnemy::BeginPlay()
 		MoveToTarget(PatrolTarget);
 	}
 
-	Tags.Add(FName("Enemy"));
+	Faction->SetTeam(ETeam::ET_Enemy);
+
+	RegisterWithSpatialHash();
+	RegisterWithAISubsystems();
+
+	// Before significance, whose first tier enables the bar
+	UWorld* World = GetWorld();
+	if (UHealthBarSubsystem* HealthBars = World ? World->GetSubsystem<UHealthBarSubsystem>() : nullptr)
+	{
+		HealthBars->RegisterEnemy(this);
+	}
+	if (UEnemySignificanceSubsystem* Significance = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr)
+	{
+		Significance->RegisterEnemy(this);
+	}
 }
 
-float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+void AEnemy::StopBehavior()
 {
-	SetCombatTarget(EventInstigator->GetPawn());
-	return Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+	UWorld* World = GetWorld();
+	UEnemySignificanceSubsystem* Significance = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr;
+	if (Significance)
+	{
+		Significance->UnregisterEnemy(this);
+	}
+	if (UHealthBarSubsystem* HealthBars = World ? World->GetSubsystem<UHealthBarSubsystem>() : nullptr)
+	{
+		HealthBars->UnregisterEnemy(this);
+	}
+	ReleaseCombatSlot();
+	UnregisterFromAISubsystems();
+	UnregisterFromSpatialHash();
 }
 
-void AEnemy::Destroyed()
+/// <summary>
+/// Resets everything Die and the previous life changed: the character state, movement and the health bar, then starts patrolling
+/// </summary>
+void AEnemy::OnAcquiredFromPool()
 {
+	const AEnemy* Defaults = GetClass()->GetDefaultObject<AEnemy>();
+
+	ResetCharacterState();
+
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	Movement->SetComponentTickEnabled(true);
+	Movement->bOrientRotationToMovement = true;
+	Movement->MaxWalkSpeed = Defaults->GetCharacterMovement()->MaxWalkSpeed;
+
+	EnemyState = EEnemyState::EES_Idle;
+	CombatTarget = nullptr;
+	PatrolOrigin = nullptr;
+
 	if (EquippedItem)
 	{
-		EquippedItem->Destroy();
+		EquippedItem->SetActorHiddenInGame(false);
+	}
+
+	StartBehavior();
+}
+
+/// <summary>
+/// Stops every timer, montage and move and leaves the world subsystems. The weapon stays attached for the next use
+/// </summary>
+void AEnemy::OnReleasedToPool()
+{
+	ClearAttackTimer();
+	ClearPatrolTimer();
+	SetLifeSpan(0.f);
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.f);
+	}
+	if (AIController)
+	{
+		AIController->StopMovement();
+	}
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	StopBehavior();
+	SetActorTickEnabled(false);
+
+	ToggleHealthBar(false);
+	if (EquippedItem)
+	{
+		EquippedItem->SetActorHiddenInGame(true);
+	}
+}
+
+/// <summary>
+/// Hands the per frame AI decisions and sight checks to the world subsystems.
+/// Falls back to ticking this actor when UEnemyAIManager is disabled
+/// </summary>
+void AEnemy::RegisterWithAISubsystems()
+{
+	UWorld* World = GetWorld();
+	UEnemyAIManager* AIManager = World ? World->GetSubsystem<UEnemyAIManager>() : nullptr;
+	if (AIManager && AIManager->RegisterEnemy(this))
+	{
+		SetActorTickEnabled(false);
+	}
+	else
+	{
+		SetActorTickEnabled(true);
+	}
+
+	UEnemyPerceptionSubsystem* Perception = World ? World->GetSubsystem<UEnemyPerceptionSubsystem>() : nullptr;
+	if (Perception)
+	{
+		Perception->RegisterEnemy(this, SightRadius, PeripheralVisionAngle, SensingInterval);
+	}
+}
+
+void AEnemy::UnregisterFromAISubsystems()
+{
+	UWorld* World = GetWorld();
+	UEnemyAIManager* AIManager = World ? World->GetSubsystem<UEnemyAIManager>() : nullptr;
+	if (AIManager)
+	{
+		AIManager->UnregisterEnemy(this);
+	}
+	UEnemyPerceptionSubsystem* Perception = World ? World->GetSubsystem<UEnemyPerceptionSubsystem>() : nullptr;
+	if (Perception)
+	{
+		Perception->UnregisterEnemy(this);
+	}
+}
+
+/// <summary>
+/// Applies the tick, animation, sensing and health bar settings of a significance tier
+/// </summary>
+void AEnemy::ApplySignificanceTier(const FEnemySignificanceTier& Tier)
+{
+	SetActorTickInterval(Tier.TickInterval);
+	GetCharacterMovement()->SetComponentTickInterval(Tier.TickInterval);
+	GetMesh()->SetComponentTickInterval(Tier.AnimUpdateInterval);
+
+	UWorld* World = GetWorld();
+	if (UEnemyAIManager* AIManager = World ? World->GetSubsystem<UEnemyAIManager>() : nullptr)
+	{
+		AIManager->SetUpdateInterval(this, Tier.TickInterval);
+	}
+	if (UEnemyPerceptionSubsystem* Perception = World ? World->GetSubsystem<UEnemyPerceptionSubsystem>() : nullptr)
+	{
+		Perception->SetSensingInterval(this, Tier.SensingInterval);
+	}
+
+	SetHealthBarEnabled(Tier.bHealthBar);
+}
+
+/// <summary>
+/// Puts the enemy fully to sleep: no AI, sensing, movement or animation updates and the patrol timer is paused.
+/// Waking resumes the patrol where it left off
+/// </summary>
+void AEnemy::SetSignificanceAsleep(bool bAsleep)
+{
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	GetCharacterMovement()->SetComponentTickEnabled(!bAsleep);
+	GetMesh()->SetComponentTickEnabled(!bAsleep);
+
+	if (bAsleep)
+	{
+		if (AIController)
+		{
+			AIController->StopMovement();
+		}
+		// Movement is stopped mid leg, so the next move can't start from the last marker
+		if (!TimerManager.IsTimerActive(PatrolTimer))
+		{
+			PatrolOrigin = nullptr;
+		}
+		TimerManager.PauseTimer(PatrolTimer);
+		UnregisterFromAISubsystems();
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	RegisterWithAISubsystems();
+	TimerManager.UnPauseTimer(PatrolTimer);
+	if (EnemyState == EEnemyState::EES_Patrolling && !TimerManager.IsTimerActive(PatrolTimer))
+	{
+		MoveToTarget(PatrolTarget);
+	}
+}
+
+void AEnemy::SetHealthBarEnabled(bool bEnabled)
+{
+	UWorld* World = GetWorld();
+	if (UHealthBarSubsystem* HealthBars = World ? World->GetSubsystem<UHealthBarSubsystem>() : nullptr)
+	{
+		HealthBars->SetEnabled(this, bEnabled);
+	}
+}
+
+void AEnemy::RegisterWithSpatialHash()
+{
+	UWorld* World = GetWorld();
+	USpatialHashSubsystem* SpatialHash = World ? World->GetSubsystem<USpatialHashSubsystem>() : nullptr;
+	if (SpatialHash == nullptr || SpatialHandle != INDEX_NONE)
+	{
+		return;
+	}
+
+	SpatialHandle = SpatialHash->RegisterActor(this);
+	for (AActor* Marker : PatrolMarkers)
+	{
+		SpatialHash->RegisterActor(Marker);
+	}
+}
+
+void AEnemy::UnregisterFromSpatialHash()
+{
+	UWorld* World = GetWorld();
+	USpatialHashSubsystem* SpatialHash = World ? World->GetSubsystem<USpatialHashSubsystem>() : nullptr;
+	if (SpatialHash == nullptr || SpatialHandle == INDEX_NONE)
+	{
+		return;
+	}
+
+	SpatialHash->UnregisterActor(this);
+	for (AActor* Marker : PatrolMarkers)
+	{
+		SpatialHash->UnregisterActor(Marker);
+	}
+	SpatialHandle = INDEX_NONE;
+}
+
+float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	// A corpse doesn't wake up or pick a target
+	if (!IsAlive())
+	{
+		return 0.f;
+	}
+
+	UWorld* World = GetWorld();
+	if (UEnemySignificanceSubsystem* Significance = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr)
+	{
+		Significance->WakeEnemy(this);
+	}
+	if (EventInstigator)
+	{
+		SetCombatTarget(EventInstigator->GetPawn());
 	}
+	return Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 }
 
+/// <summary>
+/// Takes the new target and lets the transition table decide what acquiring it does, CheckCombatTarget starts the chase or
+/// the attack. States that ignore the event, like Dead, keep their target and state untouched. A stunned enemy only keeps the
+/// target, SetStatusEffects acquires it when the stun ends
+/// </summary>
 void AEnemy::SetCombatTarget(APawn* Target)
 {
-	if (Target == nullptr)
+	if (Target == nullptr || EnemyStateMachine::GetTransition(EnemyState, EEnemyEvent::EEE_TargetAcquired).Reaction == EEnemyReaction::EER_Ignore)
 	{
 		return;
 	}
 	UE_LOG(LogTemp, Warning, TEXT("Enemy::SetCombatTarget"));
 	CombatTarget = Target;
-	if (!IsOutsideAttackRadius())
-	{
-		EnemyState = EEnemyState::EES_Attacking;
-	}
-	else if (IsOutsideAttackRadius())
+	if (IsStunned())
 	{
-		ClearPatrolTimer();
-		StartChasing();
+		return;
 	}
+	ClearPatrolTimer();
+	HandleEnemyEvent(EEnemyEvent::EEE_TargetAcquired);
 }
 
 void AEnemy::OnPawnSeen(APawn* Pawn)
 {
 	if (Pawn == nullptr || EnemyState >= EEnemyState::EES_Chasing || EnemyState == EEnemyState::EES_Dead) return;
 	
-	if (Pawn->ActorHasTag(FName("EngageableTarget")) && !Pawn->ActorHasTag(FName("Dead")))
+	const UFactionComponent* PawnFaction = UFactionComponent::FindFaction(Pawn);
+	if (PawnFaction && PawnFaction->IsTargetable() && Faction->IsHostileTo(PawnFaction))
 	{
 		SetCombatTarget(Pawn);
 	}
@@ -112,39 +373,60 @@ void AEnemy::Die_Implementation()
 {
 	Super::Die_Implementation();
 	ClearAttackTimer();
+	ReleaseCombatSlot();
 	GetCharacterMovement()->bOrientRotationToMovement = false;
 	ToggleHealthBar(false);
 
-	SetLifeSpan(DeathLifeSpan);
+	// Pooled corpses are recycled after DeathLifeSpan, or earlier when too many are lying around
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (Pool)
+	{
+		Pool->AddCorpse(this, DeathLifeSpan);
+	}
+	else
+	{
+		SetLifeSpan(DeathLifeSpan);
+	}
 	EnemyState = EEnemyState::EES_Dead;
 
 	if (ItemToDrop)
 	{
-		UWorld* World = GetWorld();
-		if (World)
+		const FVector SpawnLocation = GetActorLocation() + FVector(0.f, 0.f, 25.f);
+		if (Pool)
 		{
-			const FVector SpawnLocation = GetActorLocation() + FVector(0.f, 0.f, 25.f);
-			World->SpawnActor<AItem>(ItemToDrop, SpawnLocation, GetActorRotation());
+			Pool->RequestSpawn(ItemToDrop, FTransform(GetActorRotation(), SpawnLocation));
+		}
+		else
+		{
+			GetWorld()->SpawnActor<AItem>(ItemToDrop, SpawnLocation, GetActorRotation());
 		}
 	}
+	HandleEnemyEvent(EEnemyEvent::EEE_Die);
 }
 
 bool AEnemy::CanAttack()
 {
-	return EnemyState < EEnemyState::EES_Attacking && !IsOutsideAttackRadius() && EnemyState != EEnemyState::EES_Dead;
+	return CanAttackFromRange(IsOutsideAttackRadius());
+}
+
+bool AEnemy::CanAttackFromRange(bool bOutsideAttackRadius) const
+{
+	const bool bCanStartAttack = EnemyState < EEnemyState::EES_Attacking || EnemyState == EEnemyState::EES_Waiting;
+	return bCanStartAttack && !bOutsideAttackRadius && EnemyState != EEnemyState::EES_Dead;
 }
 
 bool AEnemy::InTargetRange(AActor* Actor, double Radius)
 {
 	if (Actor == nullptr) return false;
 
-	const double DistanceToTarget = (Actor->GetActorLocation() - GetActorLocation()).Size();
-	return DistanceToTarget <= Radius;
+	const double DistanceToTargetSq = FVector::DistSquared(Actor->GetActorLocation(), GetActorLocation());
+	return DistanceToTargetSq <= Radius * Radius;
 }
 
 void AEnemy::PatrolTimerFinished()
 {
 	MoveToTarget(PatrolTarget);
+	HandleEnemyEvent(EEnemyEvent::EEE_PatrolTimerExpired);
 }
 
 void AEnemy::ClearPatrolTimer()
@@ -154,7 +436,7 @@ void AEnemy::ClearPatrolTimer()
 
 void AEnemy::MoveToTarget(AActor* Target)
 {
-	if (!Target)
+	if (!Target || IsStunned())
 	{
 		return;
 	}
@@ -162,6 +444,19 @@ void AEnemy::MoveToTarget(AActor* Target)
 	FAIMoveRequest MoveRequest;
 	MoveRequest.SetGoalActor(Target);
 	MoveRequest.SetAcceptanceRadius(MoveToAcceptanceRadius);
+
+	// Marker to marker patrol legs reuse the path shared by every enemy walking between the same markers
+	if (Target == PatrolTarget && PatrolOrigin && PatrolOrigin != Target)
+	{
+		UPatrolPathCache* PathCache = GetWorld()->GetSubsystem<UPatrolPathCache>();
+		FNavPathSharedPtr Path = PathCache ? PathCache->FindOrBuildPath(PatrolOrigin, Target, *this, AIController->GetNavAgentPropertiesRef(), GetNavAgentLocation()) : nullptr;
+		if (Path.IsValid())
+		{
+			AIController->RequestMove(MoveRequest, Path);
+			return;
+		}
+	}
+
 	AIController->MoveTo(MoveRequest);
 }
 
@@ -170,7 +465,8 @@ void AEnemy::SpawnDefaultWeapon()
 	UWorld* World = GetWorld();
 	if (World && WeaponClass)
 	{
-		AWeapon* DefaultWeapon = World->SpawnActor<AWeapon>(WeaponClass);
+		UActorPoolSubsystem* Pool = World->GetSubsystem<UActorPoolSubsystem>();
+		AWeapon* DefaultWeapon = Pool ? Pool->Acquire<AWeapon>(WeaponClass, FTransform::Identity) : World->SpawnActor<AWeapon>(WeaponClass);
 		DefaultWeapon->Equip(GetMesh(), FName("WeaponSocket"), this, this);
 		EquippedItem = DefaultWeapon;
 	}
@@ -178,30 +474,35 @@ void AEnemy::SpawnDefaultWeapon()
 
 void AEnemy::ToggleHealthBar(bool bShow)
 {
-	if (HealthBarWidget)
+	UWorld* World = GetWorld();
+	if (UHealthBarSubsystem* HealthBars = World ? World->GetSubsystem<UHealthBarSubsystem>() : nullptr)
 	{
-		HealthBarWidget->SetVisibility(bShow);
+		HealthBars->SetShown(this, bShow);
 	}
 }
 
 void AEnemy::LoseInterest()
 {
 	CombatTarget = nullptr;
+	ReleaseCombatSlot();
 	ToggleHealthBar(false);
 }
 
 void AEnemy::StartPatrolling()
 {
 	EnemyState = EEnemyState::EES_Patrolling;
-	GetCharacterMovement()->MaxWalkSpeed = PatrolWalkSpeed;
+	PatrolOrigin = nullptr;
+	GetCharacterMovement()->MaxWalkSpeed = PatrolWalkSpeed * GetSlowMultiplier();
 	MoveToTarget(PatrolTarget);
 	UE_LOG(LogTemp, Warning, TEXT("Enemy::CheckCombatTarget::Start Patrol"));
 }
 
 void AEnemy::StartChasing()
 {
+	// Out of attack range, give the token and slot to an enemy that can use them
+	ReleaseCombatSlot();
 	EnemyState = EEnemyState::EES_Chasing;
-	GetCharacterMovement()->MaxWalkSpeed = ChaseWalkSpeed;
+	GetCharacterMovement()->MaxWalkSpeed = ChaseWalkSpeed * GetSlowMultiplier();
 	MoveToTarget(CombatTarget);
 	UE_LOG(LogTemp, Warning, TEXT("Enemy::CheckCombatTarget::Chasing"));
 }
@@ -228,13 +529,66 @@ void AEnemy::ClearAttackTimer()
 	GetWorldTimerManager().ClearTimer(AttackTimer);
 }
 
+/// <summary>
+/// Starts the attack timer if the target has an attack token to spare, otherwise waits for one
+/// </summary>
+void AEnemy::TryStartAttack()
+{
+	UCombatCoordinator* Coordinator = GetWorld()->GetSubsystem<UCombatCoordinator>();
+	if (Coordinator == nullptr || Coordinator->RequestAttackToken(this, CombatTarget))
+	{
+		StartAttackTimer();
+	}
+	else if (EnemyState != EEnemyState::EES_Waiting)
+	{
+		StartWaiting();
+	}
+}
+
+/// <summary>
+/// Walks to a free engagement slot around the target, or stands still when they are all taken
+/// </summary>
+void AEnemy::StartWaiting()
+{
+	EnemyState = EEnemyState::EES_Waiting;
+	if (AIController == nullptr)
+	{
+		return;
+	}
+
+	// Just clear of the target's capsule, capped at the attack radius so the enemy is still in range when a token comes
+	const double TargetRadius = CombatTarget ? CombatTarget->GetSimpleCollisionRadius() : 0.0;
+	const double SlotRadius = FMath::Min(TargetRadius + GetCapsuleComponent()->GetScaledCapsuleRadius() + EngagementSlotMargin, AttackRadius);
+
+	UCombatCoordinator* Coordinator = GetWorld()->GetSubsystem<UCombatCoordinator>();
+	FVector SlotLocation;
+	if (Coordinator && Coordinator->ClaimEngagementSlot(this, CombatTarget, SlotRadius, SlotLocation))
+	{
+		AIController->MoveToLocation(SlotLocation, MoveToAcceptanceRadius);
+	}
+	else
+	{
+		AIController->StopMovement();
+	}
+}
+
+void AEnemy::ReleaseCombatSlot()
+{
+	UWorld* World = GetWorld();
+	UCombatCoordinator* Coordinator = World ? World->GetSubsystem<UCombatCoordinator>() : nullptr;
+	if (Coordinator)
+	{
+		Coordinator->ReleaseEnemy(this);
+	}
+}
+
 void AEnemy::HandleDamage(float Damage)
 {
 	Super::HandleDamage(Damage);
 
-	if (HealthBarWidget && IsAlive())
+	// The percent reaches UHealthBarSubsystem through OnHealthChanged
+	if (IsAlive())
 	{
-		HealthBarWidget->SetHealthPercent(Attributes->GetHealthPercent());
 		ToggleHealthBar(true);
 	}
 }
@@ -242,22 +596,85 @@ void AEnemy::HandleDamage(float Damage)
 void AEnemy::Attack()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Enemy::Attack"));
-	if (CombatTarget && CombatTarget->ActorHasTag("Dead"))
+	if (CombatTarget && UFactionComponent::IsActorDead(CombatTarget))
 	{
 		CombatTarget = nullptr;
-		return;
 	}
-	EnemyState = EEnemyState::EES_Engaged;
-	Super::Attack();
+	else
+	{
+		EnemyState = EEnemyState::EES_Engaged;
+		Super::Attack();
+	}
+	HandleEnemyEvent(EEnemyEvent::EEE_AttackTimerExpired);
 }
 
 void AEnemy::AttackEnd()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Enemy::AttackEnd"));
 	Super::AttackEnd();
-	EnemyState = EEnemyState::EES_Idle;
-	
-	CheckCombatTarget();
+	// A dead enemy stays dead even if its attack montage notifies late
+	if (EnemyState != EEnemyState::EES_Dead)
+	{
+		EnemyState = EEnemyState::EES_Idle;
+		// Handed to the longest waiting enemy first, this one asks again when it re-evaluates below
+		if (UCombatCoordinator* Coordinator = GetWorld()->GetSubsystem<UCombatCoordinator>())
+		{
+			Coordinator->ReleaseAttackToken(this);
+		}
+	}
+	HandleEnemyEvent(EEnemyEvent::EEE_AttackEnd);
+}
+
+/// <summary>
+/// A stun freezes the enemy in place: its move, the patrol and attack timers and the playing montage are paused, and Tick and the
+/// AI events are skipped. When it ends they resume and EEE_StunEnded re-evaluates once for every event the stun dropped.
+/// A patrol just carries on, its paused move and timer still stand. An idle or patrolling enemy that holds a target got it, or
+/// had its attack cut short, during the stun, so that target is acquired instead
+/// </summary>
+void AEnemy::SetStatusEffects(bool bInStunned, float InSlowMultiplier)
+{
+	const bool bWasStunned = IsStunned();
+	Super::SetStatusEffects(bInStunned, InSlowMultiplier);
+	if (bInStunned == bWasStunned || !IsAlive())
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (bInStunned)
+	{
+		if (AIController)
+		{
+			AIController->PauseMove(FAIRequestID::CurrentRequest);
+		}
+		TimerManager.PauseTimer(PatrolTimer);
+		TimerManager.PauseTimer(AttackTimer);
+		if (AnimInstance)
+		{
+			AnimInstance->Montage_Pause(nullptr);
+		}
+		return;
+	}
+
+	if (AIController)
+	{
+		AIController->ResumeMove(FAIRequestID::CurrentRequest);
+	}
+	TimerManager.UnPauseTimer(PatrolTimer);
+	TimerManager.UnPauseTimer(AttackTimer);
+	if (AnimInstance)
+	{
+		AnimInstance->Montage_Resume(nullptr);
+	}
+
+	if (CombatTarget && (EnemyState == EEnemyState::EES_Idle || EnemyState == EEnemyState::EES_Patrolling))
+	{
+		ClearPatrolTimer();
+		HandleEnemyEvent(EEnemyEvent::EEE_TargetAcquired);
+		return;
+	}
+	HandleEnemyEvent(EEnemyEvent::EEE_StunEnded);
 }
 
 void AEnemy::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
@@ -270,19 +687,30 @@ void AEnemy::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 
 	StopAttackMontage();
 
-	if (!IsOutsideAttackRadius())
+	if (IsStunned())
+	{
+		// Nothing restarts the cut short attack while stunned, so it ends here and hands its token on until EEE_StunEnded
+		if (EnemyState == EEnemyState::EES_Attacking || EnemyState == EEnemyState::EES_Engaged)
+		{
+			AttackEnd();
+		}
+	}
+	else if (!IsOutsideAttackRadius())
 	{
-		if (IsAlive()) // Note: We get Hit then take damage so this may start attack timer even though we will be dead shortly
+		if (IsAlive()) // Note: Without UDamageQueueSubsystem we get Hit then take damage so this may start attack timer even though we will be dead shortly
 		{
-			StartAttackTimer();
+			TryStartAttack();
 		}
 	}
+	HandleEnemyEvent(EEnemyEvent::EEE_GetHit);
 }
 
 void AEnemy::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	if (EnemyState == EEnemyState::EES_Dead) return;
+	if (EnemyState == EEnemyState::EES_Dead || IsStunned()) return;
+	// Woken by UCombatCoordinator when a token is free, only leaving attack range needs checking
+	if (EnemyState == EEnemyState::EES_Waiting && !IsOutsideAttackRadius()) return;
 
 	if (EnemyState > EEnemyState::EES_Patrolling)
 	{
@@ -295,11 +723,82 @@ void AEnemy::Tick(float DeltaTime)
 
 }
 
+/// <summary>
+/// Re-runs the decision the transition table picks for the current state and event, measuring ranges on demand.
+/// With UEnemyAIManager this replaces the per frame polling in Tick
+/// </summary>
+void AEnemy::HandleEnemyEvent(EEnemyEvent Event)
+{
+	// Dropped, EEE_StunEnded re-evaluates once when the stun ends
+	if (IsStunned())
+	{
+		return;
+	}
+
+	const EEnemyState FromState = EnemyState;
+	switch (EnemyStateMachine::GetTransition(FromState, Event).Reaction)
+	{
+	case EEnemyReaction::EER_EvaluatePatrol:
+		CheckPatrolTarget();
+		break;
+	case EEnemyReaction::EER_EvaluateCombat:
+		CheckCombatTarget();
+		break;
+	default:
+		break;
+	}
+	FinishEnemyEvent(FromState, Event);
+}
+
+/// <summary>
+/// Same as above with ranges already computed by UEnemyAIManager
+/// </summary>
+void AEnemy::HandleEnemyEvent(EEnemyEvent Event, EEnemyRangeFlags RangeFlags)
+{
+	// Dropped, EEE_StunEnded re-evaluates once when the stun ends
+	if (IsStunned())
+	{
+		return;
+	}
+
+	const EEnemyState FromState = EnemyState;
+	switch (EnemyStateMachine::GetTransition(FromState, Event).Reaction)
+	{
+	case EEnemyReaction::EER_EvaluatePatrol:
+		CheckPatrolTarget(EnumHasAnyFlags(RangeFlags, EEnemyRangeFlags::InPatrolRange));
+		break;
+	case EEnemyReaction::EER_EvaluateCombat:
+		CheckCombatTarget(!EnumHasAnyFlags(RangeFlags, EEnemyRangeFlags::InCombatRadius), !EnumHasAnyFlags(RangeFlags, EEnemyRangeFlags::InAttackRadius));
+		break;
+	default:
+		break;
+	}
+	FinishEnemyEvent(FromState, Event);
+}
+
+void AEnemy::FinishEnemyEvent(EEnemyState FromState, EEnemyEvent Event)
+{
+	ensureMsgf(EnemyStateMachine::GetTransition(FromState, Event).Allows(EnemyState),
+		TEXT("%s: transition from state %d on event %d to state %d is not in the table"),
+		*GetName(), static_cast<int32>(FromState), static_cast<int32>(Event), static_cast<int32>(EnemyState));
+
+	// The state or target may have changed, have the manager re-check ranges against the current target
+	if (AIManagerIndex != INDEX_NONE)
+	{
+		GetWorld()->GetSubsystem<UEnemyAIManager>()->MarkDirty(this);
+	}
+}
+
 void AEnemy::CheckPatrolTarget()
+{
+	CheckPatrolTarget(InTargetRange(PatrolTarget, PatrolRadius));
+}
+
+void AEnemy::CheckPatrolTarget(bool bInPatrolRange)
 {
 	AActor* OldPatrolTarget = PatrolTarget;
 	EnemyState = EEnemyState::EES_Patrolling;
-	if (InTargetRange(PatrolTarget, 200.f))
+	if (bInPatrolRange)
 	{
 		GetPatrolTarget();
 
@@ -308,6 +807,7 @@ void AEnemy::CheckPatrolTarget()
 			return;
 		}
 
+		PatrolOrigin = OldPatrolTarget;
 		const float PauseDelay = FMath::RandRange(0.5f, 5.f);
 		GetWorldTimerManager().SetTimer(PatrolTimer, this, &AEnemy::PatrolTimerFinished, PauseDelay);
 	}
@@ -328,7 +828,12 @@ void AEnemy::GetPatrolTarget()
 
 void AEnemy::CheckCombatTarget()
 {
-	if (IsOutsideCombatRadius())
+	CheckCombatTarget(IsOutsideCombatRadius(), IsOutsideAttackRadius());
+}
+
+void AEnemy::CheckCombatTarget(bool bOutsideCombatRadius, bool bOutsideAttackRadius)
+{
+	if (bOutsideCombatRadius)
 	{
 		ClearAttackTimer();
 		LoseInterest();
@@ -337,7 +842,7 @@ void AEnemy::CheckCombatTarget()
 			StartPatrolling();
 		}
 	}
-	else if (EnemyState != EEnemyState::EES_Chasing && IsOutsideAttackRadius())
+	else if (EnemyState != EEnemyState::EES_Chasing && bOutsideAttackRadius)
 	{
 		ClearAttackTimer();
 		if (EnemyState != EEnemyState::EES_Engaged)
@@ -345,9 +850,9 @@ void AEnemy::CheckCombatTarget()
 			StartChasing();
 		}
 	}
-	else if (CanAttack())
+	else if (CanAttackFromRange(bOutsideAttackRadius))
 	{
-		StartAttackTimer();
+		TryStartAttack();
 	}
 }
 
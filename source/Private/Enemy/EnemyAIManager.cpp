@@ -0,0 +1,387 @@
+#include "Enemy/EnemyAIManager.h"
+#include "Enemy/Enemy.h"
+#include "Spatial/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("EnemyAIManager Tick"), STAT_EnemyAIManagerTick, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyAIManager Enemies"), STAT_EnemyAIManagerEnemies, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyAIManager Enemies Updated"), STAT_EnemyAIManagerUpdated, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyAIManager Range Tests"), STAT_EnemyAIManagerRangeTests, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyAIManager Range Events"), STAT_EnemyAIManagerRangeEvents, STATGROUP_Slash);
+
+static TAutoConsoleVariable<bool> CVarEnemyAIManagerEnabled(
+	TEXT("slash.EnemyAIManager.Enabled"),
+	true,
+	TEXT("When true enemies are updated by the batched UEnemyAIManager instead of ticking individually. Read when a world is created."));
+
+bool UEnemyAIManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && CVarEnemyAIManagerEnabled.GetValueOnGameThread();
+}
+
+bool UEnemyAIManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyAIManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	SpatialHash = Collection.InitializeDependency<USpatialHashSubsystem>();
+}
+
+void UEnemyAIManager::Deinitialize()
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+		{
+			Enemy->AIManagerIndex = INDEX_NONE;
+		}
+	}
+	Enemies.Empty();
+	Targets.Empty();
+	TargetHandles.Empty();
+	IsQueued.Empty();
+	ForceDispatch.Empty();
+	UpdateIntervals.Empty();
+	NextUpdateTimes.Empty();
+	PatrolRadiiSq.Empty();
+	CombatRadiiSq.Empty();
+	AttackRadiiSq.Empty();
+	RangeFlags.Empty();
+	Queue.Empty();
+	UpdatingQueue.Empty();
+	PendingUnregisters.Empty();
+	EnemiesBySelfHandle.Empty();
+	EnemiesByTargetHandle.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyAIManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyAIManager, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Adds the enemy to the event driven update. Its first update always runs the decision for its current state,
+/// which is what moves an enemy spawned without a patrol target from Idle to Patrolling
+/// </summary>
+/// <returns>True if the enemy was registered and no longer needs its own tick</returns>
+bool UEnemyAIManager::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr)
+	{
+		return false;
+	}
+	// Unregistered and registered again during the same update, the slot is still there
+	if (PendingUnregisters.RemoveSingleSwap(Enemy, false) > 0)
+	{
+		return true;
+	}
+	if (Enemy->AIManagerIndex != INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 Index = Enemies.Add(Enemy);
+	Enemy->AIManagerIndex = Index;
+	Targets.AddDefaulted();
+	TargetHandles.Add(INDEX_NONE);
+	IsQueued.Add(false);
+	ForceDispatch.Add(true);
+	UpdateIntervals.Add(0.f);
+	NextUpdateTimes.Add(0.0);
+	PatrolRadiiSq.Add(FMath::Square(Enemy->PatrolRadius));
+	CombatRadiiSq.Add(FMath::Square(Enemy->CombatRadius));
+	AttackRadiiSq.Add(FMath::Square(Enemy->AttackRadius));
+	RangeFlags.Add(EEnemyRangeFlags::None);
+
+	if (Enemy->SpatialHandle != INDEX_NONE)
+	{
+		EnemiesBySelfHandle.Add(Enemy->SpatialHandle, Enemy);
+	}
+	Enqueue(Index);
+	return true;
+}
+
+/// <summary>
+/// Removes the enemy from the update. During Tick's update loop, where an enemy can die or be pooled by its own event, the
+/// removal waits until the loop is done so no slot it has yet to visit moves
+/// </summary>
+void UEnemyAIManager::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->AIManagerIndex) || Enemies[Enemy->AIManagerIndex] != Enemy)
+	{
+		return;
+	}
+
+	if (bUpdating)
+	{
+		PendingUnregisters.AddUnique(Enemy);
+		return;
+	}
+	RemoveEnemy(Enemy);
+}
+
+/// <summary>
+/// The last slot is swapped into the removed one
+/// </summary>
+void UEnemyAIManager::RemoveEnemy(AEnemy* Enemy)
+{
+	const int32 Index = Enemy->AIManagerIndex;
+	const int32 LastIndex = Enemies.Num() - 1;
+
+	WatchTargetHandle(Index, INDEX_NONE);
+	if (Enemy->SpatialHandle != INDEX_NONE)
+	{
+		EnemiesBySelfHandle.Remove(Enemy->SpatialHandle);
+	}
+
+	// Queued slot indices have to follow the swap
+	for (TArray<int32>* Slots : { &Queue, &UpdatingQueue })
+	{
+		Slots->RemoveSingleSwap(Index, false);
+		const int32 LastSlot = Slots->Find(LastIndex);
+		if (LastSlot != INDEX_NONE)
+		{
+			(*Slots)[LastSlot] = Index;
+		}
+	}
+
+	Enemies.RemoveAtSwap(Index, 1, false);
+	Targets.RemoveAtSwap(Index, 1, false);
+	TargetHandles.RemoveAtSwap(Index, 1, false);
+	IsQueued.RemoveAtSwap(Index, 1, false);
+	ForceDispatch.RemoveAtSwap(Index, 1, false);
+	UpdateIntervals.RemoveAtSwap(Index, 1, false);
+	NextUpdateTimes.RemoveAtSwap(Index, 1, false);
+	PatrolRadiiSq.RemoveAtSwap(Index, 1, false);
+	CombatRadiiSq.RemoveAtSwap(Index, 1, false);
+	AttackRadiiSq.RemoveAtSwap(Index, 1, false);
+	RangeFlags.RemoveAtSwap(Index, 1, false);
+
+	if (Enemies.IsValidIndex(Index))
+	{
+		Enemies[Index]->AIManagerIndex = Index;
+	}
+	Enemy->AIManagerIndex = INDEX_NONE;
+}
+
+/// <summary>
+/// Sets how often an enemy that keeps needing updates is looked at. Zero means every frame
+/// </summary>
+void UEnemyAIManager::SetUpdateInterval(AEnemy* Enemy, float UpdateInterval)
+{
+	if (Enemy && Enemies.IsValidIndex(Enemy->AIManagerIndex))
+	{
+		UpdateIntervals[Enemy->AIManagerIndex] = UpdateInterval;
+	}
+}
+
+/// <summary>
+/// Called after every event the enemy handled, its state or target may have changed so its ranges are re-checked next update
+/// </summary>
+void UEnemyAIManager::MarkDirty(AEnemy* Enemy)
+{
+	if (Enemy && Enemies.IsValidIndex(Enemy->AIManagerIndex))
+	{
+		Enqueue(Enemy->AIManagerIndex);
+	}
+}
+
+void UEnemyAIManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAIManagerTick);
+	SET_DWORD_STAT(STAT_EnemyAIManagerEnemies, Enemies.Num());
+
+	QueueCellChanges();
+
+	// Updating can queue enemies again, those go into the next frame's queue
+	Swap(Queue, UpdatingQueue);
+	Queue.Reset();
+	for (const int32 Index : UpdatingQueue)
+	{
+		IsQueued[Index] = false;
+	}
+
+	SET_DWORD_STAT(STAT_EnemyAIManagerUpdated, UpdatingQueue.Num());
+	const double Now = GetWorld()->GetTimeSeconds();
+	bUpdating = true;
+	for (int32 Cursor = 0; Cursor < UpdatingQueue.Num(); ++Cursor)
+	{
+		UpdateEnemy(UpdatingQueue[Cursor], Now);
+	}
+	bUpdating = false;
+	UpdatingQueue.Reset();
+
+	for (AEnemy* Enemy : PendingUnregisters)
+	{
+		RemoveEnemy(Enemy);
+	}
+	PendingUnregisters.Reset();
+}
+
+/// <summary>
+/// Queues every enemy that changed cell this frame and every enemy whose target did
+/// </summary>
+void UEnemyAIManager::QueueCellChanges()
+{
+	if (SpatialHash == nullptr)
+	{
+		return;
+	}
+
+	for (const int32 Handle : SpatialHash->GetGrid().GetCellChangesThisFrame())
+	{
+		if (AEnemy* const* Enemy = EnemiesBySelfHandle.Find(Handle))
+		{
+			Enqueue((*Enemy)->AIManagerIndex);
+		}
+		for (TMultiMap<int32, AEnemy*>::TConstKeyIterator It(EnemiesByTargetHandle, Handle); It; ++It)
+		{
+			Enqueue(It.Value()->AIManagerIndex);
+		}
+	}
+}
+
+/// <summary>
+/// Recomputes the range flags against the current target and raises EEE_RangeChanged when one of them flipped.
+/// Enemies stay queued while a radius could be crossed without changing cell, or while standing at a patrol marker,
+/// where the polling code kept picking a random marker every frame until it got a different one
+/// </summary>
+void UEnemyAIManager::UpdateEnemy(int32 Index, double Now)
+{
+	AEnemy* Enemy = Enemies[Index];
+	if (Enemy->EnemyState == EEnemyState::EES_Dead || PendingUnregisters.Contains(Enemy))
+	{
+		return;
+	}
+
+	if (NextUpdateTimes[Index] > Now)
+	{
+		Enqueue(Index);
+		return;
+	}
+	NextUpdateTimes[Index] = Now + UpdateIntervals[Index];
+
+	RefreshTarget(Index);
+
+	bool bNeedsExactTest = false;
+	const EEnemyRangeFlags Flags = ComputeRangeFlags(Index, bNeedsExactTest);
+	const bool bAtPatrolMarker = Enemy->EnemyState <= EEnemyState::EES_Patrolling && EnumHasAnyFlags(Flags, EEnemyRangeFlags::InPatrolRange);
+	const bool bChanged = Flags != RangeFlags[Index] || ForceDispatch[Index];
+	RangeFlags[Index] = Flags;
+	ForceDispatch[Index] = false;
+
+	if (bChanged || bAtPatrolMarker)
+	{
+		INC_DWORD_STAT(STAT_EnemyAIManagerRangeEvents);
+		Enemy->HandleEnemyEvent(EEnemyEvent::EEE_RangeChanged, Flags);
+	}
+
+	if (bNeedsExactTest || bAtPatrolMarker)
+	{
+		Enqueue(Index);
+	}
+}
+
+/// <summary>
+/// Combat states track CombatTarget, everything else tracks PatrolTarget (matches AEnemy::Tick)
+/// </summary>
+void UEnemyAIManager::RefreshTarget(int32 Index)
+{
+	const AEnemy* Enemy = Enemies[Index];
+	AActor* Target = Enemy->EnemyState > EEnemyState::EES_Patrolling ? Enemy->CombatTarget : Enemy->PatrolTarget;
+	const int32 TargetHandle = SpatialHash && Target ? SpatialHash->FindHandle(Target) : INDEX_NONE;
+
+	// Handles are reused once an actor leaves the grid, so the handle is checked as well as the target
+	if (Targets[Index] == TObjectKey<AActor>(Target) && TargetHandles[Index] == TargetHandle)
+	{
+		return;
+	}
+
+	Targets[Index] = Target;
+	WatchTargetHandle(Index, TargetHandle);
+}
+
+/// <summary>
+/// Target locations come from the spatial hash when both actors are tracked by it.
+/// Enemies whose cell is further than any of their radii from the target's cell are not distance tested
+/// </summary>
+/// <param name="bOutNeedsExactTest">True if the enemy has to be tested again next update to catch a radius crossing</param>
+EEnemyRangeFlags UEnemyAIManager::ComputeRangeFlags(int32 Index, bool& bOutNeedsExactTest)
+{
+	const AEnemy* Enemy = Enemies[Index];
+	const AActor* Target = Enemy->EnemyState > EEnemyState::EES_Patrolling ? Enemy->CombatTarget : Enemy->PatrolTarget;
+	EEnemyRangeFlags Flags = EEnemyRangeFlags::None;
+	bOutNeedsExactTest = false;
+	if (Target == nullptr)
+	{
+		return Flags;
+	}
+
+	FVector Location;
+	FVector TargetLocation;
+	const FSpatialHashGrid* Grid = SpatialHash ? &SpatialHash->GetGrid() : nullptr;
+	const int32 SelfHandle = Enemy->SpatialHandle;
+	const int32 TargetHandle = TargetHandles[Index];
+	if (Grid && Grid->IsValidHandle(SelfHandle) && Grid->IsValidHandle(TargetHandle))
+	{
+		const double MaxRadiusSq = FMath::Max3(PatrolRadiiSq[Index], CombatRadiiSq[Index], AttackRadiiSq[Index]);
+		if (Grid->GetCellDistanceLowerBoundSq(Grid->GetEntryCell(SelfHandle), Grid->GetEntryCell(TargetHandle)) > MaxRadiusSq)
+		{
+			// Nothing can change until one of the two changes cell
+			return Flags;
+		}
+		Location = Grid->GetLocation(SelfHandle);
+		TargetLocation = Grid->GetLocation(TargetHandle);
+	}
+	else
+	{
+		// Not tracked by the grid, no cell changes will be reported so keep testing
+		Location = Enemy->GetActorLocation();
+		TargetLocation = Target->GetActorLocation();
+	}
+
+	bOutNeedsExactTest = true;
+	INC_DWORD_STAT(STAT_EnemyAIManagerRangeTests);
+	const double DistanceSq = FVector::DistSquared(Location, TargetLocation);
+	if (DistanceSq <= PatrolRadiiSq[Index])
+	{
+		Flags |= EEnemyRangeFlags::InPatrolRange;
+	}
+	if (DistanceSq <= CombatRadiiSq[Index])
+	{
+		Flags |= EEnemyRangeFlags::InCombatRadius;
+	}
+	if (DistanceSq <= AttackRadiiSq[Index])
+	{
+		Flags |= EEnemyRangeFlags::InAttackRadius;
+	}
+	return Flags;
+}
+
+void UEnemyAIManager::Enqueue(int32 Index)
+{
+	if (!IsQueued[Index])
+	{
+		IsQueued[Index] = true;
+		Queue.Add(Index);
+	}
+}
+
+void UEnemyAIManager::WatchTargetHandle(int32 Index, int32 TargetHandle)
+{
+	AEnemy* Enemy = Enemies[Index];
+	if (TargetHandles[Index] != INDEX_NONE)
+	{
+		EnemiesByTargetHandle.RemoveSingle(TargetHandles[Index], Enemy);
+	}
+	TargetHandles[Index] = TargetHandle;
+	if (TargetHandle != INDEX_NONE)
+	{
+		EnemiesByTargetHandle.Add(TargetHandle, Enemy);
+	}
+}
@@ -0,0 +1,252 @@
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("EnemyPerception Tick"), STAT_EnemyPerceptionTick, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyPerception Queries"), STAT_EnemyPerceptionQueries, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemyPerception Dropped Traces"), STAT_EnemyPerceptionDropped, STATGROUP_Slash);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("EnemyPerception Avg Detection Latency (ms)"), STAT_EnemyPerceptionLatency, STATGROUP_Slash);
+
+void UEnemyPerceptionSubsystem::Deinitialize()
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+		{
+			Enemy->PerceptionIndex = INDEX_NONE;
+		}
+	}
+	Enemies.Empty();
+	SightRadiiSq.Empty();
+	PeripheralVisionCosines.Empty();
+	SensingIntervals.Empty();
+	NextSenseTimes.Empty();
+	CandidateSinceTimes.Empty();
+	CandidatePawns.Empty();
+	PendingTraces.Empty();
+	Super::Deinitialize();
+}
+
+bool UEnemyPerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Registers an enemy for sight checks. Equivalent to the old per enemy UPawnSensingComponent setup
+/// </summary>
+/// <param name="PeripheralVisionAngle">Half angle of the sight cone in degrees</param>
+/// <param name="SensingInterval">Seconds between sight checks for this enemy</param>
+void UEnemyPerceptionSubsystem::RegisterEnemy(AEnemy* Enemy, float SightRadius, float PeripheralVisionAngle, float SensingInterval)
+{
+	if (Enemy == nullptr || Enemy->PerceptionIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	Enemy->PerceptionIndex = Enemies.Add(Enemy);
+	SightRadiiSq.Add(FMath::Square(static_cast<double>(SightRadius)));
+	PeripheralVisionCosines.Add(FMath::Cos(FMath::DegreesToRadians(PeripheralVisionAngle)));
+	SensingIntervals.Add(SensingInterval);
+	// Spread the first checks out so enemies spawned on the same frame don't all sense together
+	NextSenseTimes.Add(Now + FMath::FRandRange(0.f, SensingInterval));
+	CandidateSinceTimes.Add(-1.0);
+}
+
+void UEnemyPerceptionSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->PerceptionIndex) || Enemies[Enemy->PerceptionIndex] != Enemy)
+	{
+		return;
+	}
+
+	const int32 Index = Enemy->PerceptionIndex;
+	Enemies.RemoveAtSwap(Index, 1, false);
+	SightRadiiSq.RemoveAtSwap(Index, 1, false);
+	PeripheralVisionCosines.RemoveAtSwap(Index, 1, false);
+	SensingIntervals.RemoveAtSwap(Index, 1, false);
+	NextSenseTimes.RemoveAtSwap(Index, 1, false);
+	CandidateSinceTimes.RemoveAtSwap(Index, 1, false);
+
+	if (Enemies.IsValidIndex(Index))
+	{
+		Enemies[Index]->PerceptionIndex = Index;
+	}
+	Enemy->PerceptionIndex = INDEX_NONE;
+}
+
+void UEnemyPerceptionSubsystem::SetSensingInterval(AEnemy* Enemy, float SensingInterval)
+{
+	if (Enemy && Enemies.IsValidIndex(Enemy->PerceptionIndex))
+	{
+		SensingIntervals[Enemy->PerceptionIndex] = SensingInterval;
+	}
+}
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyPerceptionTick);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	ResolvePendingTraces(Now);
+	GatherCandidatePawns();
+	IssueSightQueries(Now);
+
+	SET_DWORD_STAT(STAT_EnemyPerceptionQueries, Stats.QueriesLastFrame);
+	SET_DWORD_STAT(STAT_EnemyPerceptionDropped, Stats.DroppedLastFrame);
+	SET_FLOAT_STAT(STAT_EnemyPerceptionLatency, Stats.GetAverageDetectionLatency() * 1000.0);
+}
+
+/// <summary>
+/// Reads back last frame's async traces. A trace with no blocking hit means the pawn is visible
+/// </summary>
+void UEnemyPerceptionSubsystem::ResolvePendingTraces(double Now)
+{
+	UWorld* World = GetWorld();
+	for (int32 Index = PendingTraces.Num() - 1; Index >= 0; --Index)
+	{
+		FPendingSightTrace& Pending = PendingTraces[Index];
+		FTraceDatum Datum;
+		if (!World->QueryTraceData(Pending.Handle, Datum))
+		{
+			// The async trace data only lives for a couple of frames, have the enemy look again instead of waiting forever
+			const AEnemy* Enemy = Pending.Enemy.Get();
+			if (Enemy && Enemies.IsValidIndex(Enemy->PerceptionIndex))
+			{
+				NextSenseTimes[Enemy->PerceptionIndex] = Now;
+			}
+			PendingTraces.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		AEnemy* Enemy = Pending.Enemy.Get();
+		APawn* Pawn = Pending.Pawn.Get();
+		const bool bBlocked = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+		if (Enemy && Pawn && !bBlocked)
+		{
+			++Stats.TotalDetections;
+			Stats.TotalDetectionLatency += Now - Pending.CandidateSince;
+			if (Enemies.IsValidIndex(Enemy->PerceptionIndex))
+			{
+				CandidateSinceTimes[Enemy->PerceptionIndex] = -1.0;
+			}
+			Enemy->OnPawnSeen(Pawn);
+		}
+		PendingTraces.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+/// <summary>
+/// Only players are sensed, matching UPawnSensingComponent's default bOnlySensePlayers
+/// </summary>
+void UEnemyPerceptionSubsystem::GatherCandidatePawns()
+{
+	CandidatePawns.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			CandidatePawns.Add(PlayerController->GetPawn());
+		}
+	}
+}
+
+/// <summary>
+/// Visits due enemies round robin, does the cheap range and cone test and issues async line of sight traces up to the budget,
+/// counted per trace. Enemies that are due but over budget keep their place in the rotation and are counted as dropped
+/// </summary>
+void UEnemyPerceptionSubsystem::IssueSightQueries(double Now)
+{
+	Stats.QueriesLastFrame = 0;
+	Stats.DroppedLastFrame = 0;
+
+	const int32 Num = Enemies.Num();
+	if (Num == 0 || CandidatePawns.Num() == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	RoundRobinCursor = RoundRobinCursor % Num;
+	int32 ResumeCursor = INDEX_NONE;
+
+	for (int32 Step = 0; Step < Num; ++Step)
+	{
+		const int32 Index = (RoundRobinCursor + Step) % Num;
+		if (NextSenseTimes[Index] > Now)
+		{
+			continue;
+		}
+
+		// OnPawnSeen ignores everything once the enemy is in combat or dead, so don't spend a trace on it
+		AEnemy* Enemy = Enemies[Index];
+		if (Enemy->EnemyState >= EEnemyState::EES_Chasing || Enemy->EnemyState == EEnemyState::EES_Dead)
+		{
+			continue;
+		}
+
+		// Cheap range and cone test first, so the budget is charged per trace actually issued
+		const FVector EyeLocation = Enemy->GetPawnViewLocation();
+		const FVector SensorDirection = Enemy->GetActorForwardVector();
+		VisibleCandidates.Reset();
+		for (APawn* Pawn : CandidatePawns)
+		{
+			const FVector ToPawn = Pawn->GetActorLocation() - EyeLocation;
+			const double DistanceSq = ToPawn.SizeSquared();
+			if (DistanceSq <= SightRadiiSq[Index] && (ToPawn.GetSafeNormal() | SensorDirection) >= PeripheralVisionCosines[Index])
+			{
+				VisibleCandidates.Add(Pawn);
+			}
+		}
+
+		// An enemy's traces are issued together or not at all, one seeing more pawns than the whole budget gets the first ones
+		const int32 NumTraces = FMath::Min(VisibleCandidates.Num(), MaxTracesPerFrame);
+		if (NumTraces > 0 && Stats.QueriesLastFrame + NumTraces > MaxTracesPerFrame)
+		{
+			if (ResumeCursor == INDEX_NONE)
+			{
+				ResumeCursor = Index;
+			}
+			++Stats.DroppedLastFrame;
+			continue;
+		}
+
+		NextSenseTimes[Index] = Now + SensingIntervals[Index];
+		if (NumTraces == 0)
+		{
+			CandidateSinceTimes[Index] = -1.0;
+			continue;
+		}
+		if (CandidateSinceTimes[Index] < 0.0)
+		{
+			CandidateSinceTimes[Index] = Now;
+		}
+
+		for (int32 Candidate = 0; Candidate < NumTraces; ++Candidate)
+		{
+			APawn* Pawn = VisibleCandidates[Candidate];
+			FCollisionQueryParams Params(SCENE_QUERY_STAT(EnemySight), true, Enemy);
+			Params.AddIgnoredActor(Pawn);
+
+			FPendingSightTrace& Pending = PendingTraces.AddDefaulted_GetRef();
+			Pending.Enemy = Enemy;
+			Pending.Pawn = Pawn;
+			Pending.CandidateSince = CandidateSinceTimes[Index];
+			Pending.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, EyeLocation, Pawn->GetActorLocation(), ECollisionChannel::ECC_Visibility, Params);
+			++Stats.QueriesLastFrame;
+		}
+	}
+
+	RoundRobinCursor = ResumeCursor != INDEX_NONE ? ResumeCursor : RoundRobinCursor;
+	Stats.TotalQueries += Stats.QueriesLastFrame;
+	Stats.TotalDropped += Stats.DroppedLastFrame;
+}
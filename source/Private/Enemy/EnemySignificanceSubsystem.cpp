@@ -0,0 +1,232 @@
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/PlayerController.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("EnemySignificance Tick"), STAT_EnemySignificanceTick, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemySignificance Tier 0"), STAT_EnemySignificanceTier0, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemySignificance Tier 1"), STAT_EnemySignificanceTier1, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemySignificance Tier 2"), STAT_EnemySignificanceTier2, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemySignificance Tier 3+"), STAT_EnemySignificanceTier3, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnemySignificance Asleep"), STAT_EnemySignificanceAsleep, STATGROUP_Slash);
+
+void UEnemySignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (Tiers.Num() == 0)
+	{
+		// Defaults used when the game config does not define any tiers
+		Tiers.SetNum(4);
+		Tiers[0].MaxDistance = 2500.f;
+		Tiers[1].MaxDistance = 5000.f;
+		Tiers[1].TickInterval = 0.1f;
+		Tiers[1].AnimUpdateInterval = 1.f / 30.f;
+		Tiers[2].MaxDistance = 10000.f;
+		Tiers[2].TickInterval = 0.25f;
+		Tiers[2].AnimUpdateInterval = 0.1f;
+		Tiers[2].SensingInterval = 1.f;
+		Tiers[2].bHealthBar = false;
+		Tiers[3].MaxDistance = TNumericLimits<float>::Max();
+		Tiers[3].TickInterval = 0.5f;
+		Tiers[3].AnimUpdateInterval = 0.25f;
+		Tiers[3].SensingInterval = 2.f;
+		Tiers[3].bHealthBar = false;
+	}
+	Tiers.Sort([](const FEnemySignificanceTier& A, const FEnemySignificanceTier& B) { return A.MaxDistance < B.MaxDistance; });
+	TierCounts.Init(0, Tiers.Num());
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+		{
+			Enemy->SignificanceIndex = INDEX_NONE;
+		}
+	}
+	Enemies.Empty();
+	EnemyTiers.Empty();
+	Asleep.Empty();
+	Super::Deinitialize();
+}
+
+bool UEnemySignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Starts tracking the enemy in the most significant tier, it is re-evaluated within a few frames
+/// </summary>
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Enemy->SignificanceIndex != INDEX_NONE || Tiers.Num() == 0)
+	{
+		return;
+	}
+
+	Enemy->SignificanceIndex = Enemies.Add(Enemy);
+	EnemyTiers.Add(0);
+	Asleep.Add(false);
+	++TierCounts[0];
+	Enemy->ApplySignificanceTier(Tiers[0]);
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->SignificanceIndex) || Enemies[Enemy->SignificanceIndex] != Enemy)
+	{
+		return;
+	}
+
+	const int32 Index = Enemy->SignificanceIndex;
+	--TierCounts[EnemyTiers[Index]];
+	if (Asleep[Index])
+	{
+		--NumAsleep;
+	}
+
+	Enemies.RemoveAtSwap(Index, 1, false);
+	EnemyTiers.RemoveAtSwap(Index, 1, false);
+	Asleep.RemoveAtSwap(Index, 1, false);
+
+	if (Enemies.IsValidIndex(Index))
+	{
+		Enemies[Index]->SignificanceIndex = Index;
+	}
+	Enemy->SignificanceIndex = INDEX_NONE;
+}
+
+/// <summary>
+/// Wakes a sleeping enemy and gives it full significance until the next evaluation.
+/// Called when the enemy takes damage
+/// </summary>
+void UEnemySignificanceSubsystem::WakeEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->SignificanceIndex))
+	{
+		return;
+	}
+
+	const int32 Index = Enemy->SignificanceIndex;
+	SetAsleep(Index, false);
+	ApplyTier(Index, 0);
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificanceTick);
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	const int32 Num = Enemies.Num();
+	if (PlayerController == nullptr || Num == 0)
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	// Time sliced, every enemy is evaluated once every Num / MaxEvaluationsPerFrame frames
+	const int32 NumEvaluations = FMath::Min(Num, MaxEvaluationsPerFrame);
+	EvaluationCursor = EvaluationCursor % Num;
+	const int32 LowestTier = Tiers.Num() - 1;
+	for (int32 Step = 0; Step < NumEvaluations; ++Step)
+	{
+		const int32 Index = (EvaluationCursor + Step) % Num;
+		const AEnemy* Enemy = Enemies[Index];
+		if (Enemy->EnemyState == EEnemyState::EES_Dead)
+		{
+			continue;
+		}
+
+		const int32 NewTier = ComputeTier(Enemy, ViewLocation);
+		const bool bShouldSleep = NewTier == LowestTier && Enemy->CombatTarget == nullptr;
+		if (!bShouldSleep)
+		{
+			SetAsleep(Index, false);
+		}
+		ApplyTier(Index, NewTier);
+		if (bShouldSleep)
+		{
+			SetAsleep(Index, true);
+		}
+	}
+	EvaluationCursor = (EvaluationCursor + NumEvaluations) % Num;
+
+	SET_DWORD_STAT(STAT_EnemySignificanceTier0, TierCounts.IsValidIndex(0) ? TierCounts[0] : 0);
+	SET_DWORD_STAT(STAT_EnemySignificanceTier1, TierCounts.IsValidIndex(1) ? TierCounts[1] : 0);
+	SET_DWORD_STAT(STAT_EnemySignificanceTier2, TierCounts.IsValidIndex(2) ? TierCounts[2] : 0);
+	int32 RemainingTiers = 0;
+	for (int32 Tier = 3; Tier < TierCounts.Num(); ++Tier)
+	{
+		RemainingTiers += TierCounts[Tier];
+	}
+	SET_DWORD_STAT(STAT_EnemySignificanceTier3, RemainingTiers);
+	SET_DWORD_STAT(STAT_EnemySignificanceAsleep, NumAsleep);
+}
+
+/// <summary>
+/// Picks the first tier whose MaxDistance contains the enemy, pushed down one tier if it is off screen
+/// </summary>
+int32 UEnemySignificanceSubsystem::ComputeTier(const AEnemy* Enemy, const FVector& ViewLocation) const
+{
+	const double DistanceSq = FVector::DistSquared(Enemy->GetActorLocation(), ViewLocation);
+	const int32 LowestTier = Tiers.Num() - 1;
+
+	int32 Tier = LowestTier;
+	for (int32 Index = 0; Index < LowestTier; ++Index)
+	{
+		if (DistanceSq <= FMath::Square(static_cast<double>(Tiers[Index].MaxDistance)))
+		{
+			Tier = Index;
+			break;
+		}
+	}
+
+	if (!Enemy->WasRecentlyRendered(OffScreenGraceTime))
+	{
+		Tier = FMath::Min(Tier + 1, LowestTier);
+	}
+	return Tier;
+}
+
+void UEnemySignificanceSubsystem::ApplyTier(int32 Index, int32 NewTier)
+{
+	if (EnemyTiers[Index] == NewTier)
+	{
+		return;
+	}
+
+	--TierCounts[EnemyTiers[Index]];
+	++TierCounts[NewTier];
+	EnemyTiers[Index] = NewTier;
+	if (!Asleep[Index])
+	{
+		Enemies[Index]->ApplySignificanceTier(Tiers[NewTier]);
+	}
+}
+
+void UEnemySignificanceSubsystem::SetAsleep(int32 Index, bool bNewAsleep)
+{
+	if (Asleep[Index] == bNewAsleep)
+	{
+		return;
+	}
+
+	Asleep[Index] = bNewAsleep;
+	NumAsleep += bNewAsleep ? 1 : -1;
+	Enemies[Index]->SetSignificanceAsleep(bNewAsleep);
+	if (!bNewAsleep)
+	{
+		Enemies[Index]->ApplySignificanceTier(Tiers[EnemyTiers[Index]]);
+	}
+}
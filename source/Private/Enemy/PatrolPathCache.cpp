@@ -0,0 +1,176 @@
+#include "Enemy/PatrolPathCache.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshPath.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("PatrolPathCache Hits"), STAT_PatrolPathCacheHits, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("PatrolPathCache Misses"), STAT_PatrolPathCacheMisses, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PatrolPathCache Entries"), STAT_PatrolPathCacheEntries, STATGROUP_Slash);
+DECLARE_MEMORY_STAT(TEXT("PatrolPathCache Memory"), STAT_PatrolPathCacheMemory, STATGROUP_Slash);
+
+void UPatrolPathCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Cache.Empty(FMath::Max(MaxEntries, 1));
+}
+
+void UPatrolPathCache::Deinitialize()
+{
+	Cache.Empty();
+	DEC_MEMORY_STAT_BY(STAT_PatrolPathCacheMemory, MemoryBytes);
+	MemoryBytes = 0;
+	Super::Deinitialize();
+}
+
+bool UPatrolPathCache::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+/// <summary>
+/// Returns a path from From to To for the agent, starting at StartLocation.
+/// The result is a private copy of the cached path so each enemy's path following can observe and modify it freely
+/// </summary>
+/// <returns>Null if no path could be found</returns>
+FNavPathSharedPtr UPatrolPathCache::FindOrBuildPath(const AActor* From, const AActor* To, const AActor& Querier, const FNavAgentProperties& AgentProperties, const FVector& StartLocation)
+{
+	if (From == nullptr || To == nullptr)
+	{
+		return nullptr;
+	}
+
+	FPatrolPathKey Key;
+	Key.From = From;
+	Key.To = To;
+	Key.AgentHash = GetTypeHash(AgentProperties);
+
+	const FVector FromLocation = From->GetActorLocation();
+	const FVector ToLocation = To->GetActorLocation();
+	if (const FCachedPatrolPath* Cached = Cache.FindAndTouch(Key))
+	{
+		// The nav data invalidates registered paths whose corridor crosses a rebuilt tile, moving a marker is on us
+		const bool bMarkersInPlace = FVector::DistSquared(Cached->FromLocation, FromLocation) <= FMath::Square(MarkerMovedTolerance)
+			&& FVector::DistSquared(Cached->ToLocation, ToLocation) <= FMath::Square(MarkerMovedTolerance);
+		if (bMarkersInPlace && Cached->Path.IsValid() && Cached->Path->IsValid() && Cached->Path->IsUpToDate())
+		{
+			++Hits;
+			INC_DWORD_STAT(STAT_PatrolPathCacheHits);
+			return CopyPath(*Cached->Path, Querier, StartLocation);
+		}
+		Evict(Key);
+	}
+
+	++Misses;
+	INC_DWORD_STAT(STAT_PatrolPathCacheMisses);
+
+	FNavPathSharedPtr Path = BuildPath(From, To, AgentProperties);
+	if (!Path.IsValid())
+	{
+		return nullptr;
+	}
+
+	FCachedPatrolPath Entry;
+	Entry.Path = Path;
+	Entry.FromLocation = FromLocation;
+	Entry.ToLocation = ToLocation;
+	Entry.Bytes = sizeof(FNavMeshPath) + Path->GetPathPoints().GetAllocatedSize();
+	if (const FNavMeshPath* MeshPath = Path->CastPath<FNavMeshPath>())
+	{
+		Entry.Bytes += MeshPath->PathCorridor.GetAllocatedSize() + MeshPath->PathCorridorCost.GetAllocatedSize();
+	}
+
+	while (Cache.Num() > 0 && (Cache.Num() >= Cache.Max() || MemoryBytes + Entry.Bytes > MaxMemoryBytes))
+	{
+		EvictLeastRecent();
+	}
+
+	MemoryBytes += Entry.Bytes;
+	INC_MEMORY_STAT_BY(STAT_PatrolPathCacheMemory, Entry.Bytes);
+	Cache.Add(Key, Entry);
+	SET_DWORD_STAT(STAT_PatrolPathCacheEntries, Cache.Num());
+
+	return CopyPath(*Path, Querier, StartLocation);
+}
+
+/// <summary>
+/// Path finds between the two markers and registers the result with the nav data so tile rebuilds invalidate it
+/// </summary>
+FNavPathSharedPtr UPatrolPathCache::BuildPath(const AActor* From, const AActor* To, const FNavAgentProperties& AgentProperties) const
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FVector Start = From->GetActorLocation();
+	ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, Start);
+	if (NavData == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FPathFindingQuery Query(this, *NavData, Start, To->GetActorLocation(), NavData->GetDefaultQueryFilter());
+	const FPathFindingResult Result = NavSys->FindPathSync(AgentProperties, Query);
+	if (!Result.IsSuccessful() || Result.IsPartial())
+	{
+		return nullptr;
+	}
+
+	Result.Path->EnableRecalculationOnInvalidation(false);
+	NavData->RegisterActivePath(Result.Path);
+	return Result.Path;
+}
+
+/// <summary>
+/// Copies the cached path for one enemy. The authored points are kept as they are, the enemy's location is only prepended
+/// when it isn't already standing on the first one. The copy is registered with the nav data on its own and repaths from
+/// the enemy when a tile under it is rebuilt, instead of walking a corridor that no longer exists
+/// </summary>
+FNavPathSharedPtr UPatrolPathCache::CopyPath(const FNavigationPath& Source, const AActor& Querier, const FVector& StartLocation) const
+{
+	TSharedRef<FNavMeshPath, ESPMode::ThreadSafe> Copy = MakeShared<FNavMeshPath, ESPMode::ThreadSafe>();
+	Copy->GetPathPoints() = Source.GetPathPoints();
+	if (const FNavMeshPath* MeshPath = Source.CastPath<FNavMeshPath>())
+	{
+		Copy->PathCorridor = MeshPath->PathCorridor;
+		Copy->PathCorridorCost = MeshPath->PathCorridorCost;
+	}
+
+	TArray<FNavPathPoint>& Points = Copy->GetPathPoints();
+	if (Points.Num() > 0 && FVector::DistSquared(Points[0].Location, StartLocation) > FMath::Square(MarkerMovedTolerance))
+	{
+		FNavPathPoint Start = Points[0];
+		Start.Location = StartLocation;
+		Points.Insert(Start, 0);
+	}
+
+	ANavigationData* NavData = Source.GetNavigationDataUsed();
+	Copy->SetNavigationDataUsed(NavData);
+	Copy->SetQueryData(Source.GetQueryData());
+	Copy->SetSourceActor(Querier);
+	Copy->EnableRecalculationOnInvalidation(true);
+	Copy->MarkReady();
+	if (NavData)
+	{
+		NavData->RegisterActivePath(Copy);
+	}
+	return Copy;
+}
+
+void UPatrolPathCache::Evict(const FPatrolPathKey& Key)
+{
+	if (const FCachedPatrolPath* Entry = Cache.Find(Key))
+	{
+		MemoryBytes -= Entry->Bytes;
+		DEC_MEMORY_STAT_BY(STAT_PatrolPathCacheMemory, Entry->Bytes);
+		Cache.Remove(Key);
+	}
+}
+
+void UPatrolPathCache::EvictLeastRecent()
+{
+	const FCachedPatrolPath Entry = Cache.RemoveLeastRecent();
+	MemoryBytes -= Entry.Bytes;
+	DEC_MEMORY_STAT_BY(STAT_PatrolPathCacheMemory, Entry.Bytes);
+}
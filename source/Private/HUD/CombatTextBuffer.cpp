@@ -0,0 +1,73 @@
+#include "HUD/CombatTextBuffer.h"
+
+void FCombatTextBuffer::Init(int32 Capacity, int32 InMaxNewPerFrame)
+{
+	Entries.Reset();
+	Entries.SetNum(FMath::Max(Capacity, 1));
+	VictimSlots.Reserve(Entries.Num());
+	MaxNewPerFrame = FMath::Max(InMaxNewPerFrame, 1);
+	Reset();
+}
+
+/// <summary>
+/// Merges into the victim's number when it is younger than MergeWindow, otherwise starts a number in the next slot
+/// </summary>
+bool FCombatTextBuffer::Add(uint32 VictimId, const FVector& Location, float Amount, float MergeWindow)
+{
+	FEntry* Target = nullptr;
+	if (const int32* Slot = VictimSlots.Find(VictimId))
+	{
+		FEntry& Entry = Entries[*Slot];
+		Target = Entry.Age < MergeWindow ? &Entry : nullptr;
+	}
+
+	if (Target == nullptr)
+	{
+		if (NumNewThisFrame >= MaxNewPerFrame)
+		{
+			++NumDropped;
+			return false;
+		}
+		++NumNewThisFrame;
+
+		Target = &Entries[Head];
+		const int32* OverwrittenSlot = VictimSlots.Find(Target->VictimId);
+		if (OverwrittenSlot && *OverwrittenSlot == Head)
+		{
+			VictimSlots.Remove(Target->VictimId);
+		}
+		VictimSlots.Add(VictimId, Head);
+		Head = (Head + 1) % Entries.Num();
+
+		Target->Location = Location;
+		Target->VictimId = VictimId;
+		Target->Amount = 0.f;
+		Target->Age = 0.f;
+	}
+
+	Target->Amount += Amount;
+	return true;
+}
+
+void FCombatTextBuffer::Advance(float DeltaTime)
+{
+	for (FEntry& Entry : Entries)
+	{
+		Entry.Age += DeltaTime;
+	}
+	NumNewThisFrame = 0;
+	NumDropped = 0;
+}
+
+void FCombatTextBuffer::Reset()
+{
+	for (FEntry& Entry : Entries)
+	{
+		Entry.VictimId = 0;
+		Entry.Age = MAX_flt;
+	}
+	VictimSlots.Reset();
+	Head = 0;
+	NumNewThisFrame = 0;
+	NumDropped = 0;
+}
@@ -0,0 +1,47 @@
+#include "HUD/HUDProjection.h"
+#include "Engine/Canvas.h"
+#include "Layout/Geometry.h"
+#include "SceneView.h"
+
+bool HUDProjection::MakeView(const UCanvas* Canvas, const FVector& ViewLocation, FView& OutView)
+{
+	if (Canvas == nullptr || Canvas->SceneView == nullptr)
+	{
+		return false;
+	}
+
+	OutView.ViewProjection = Canvas->SceneView->ViewMatrices.GetViewProjectionMatrix();
+	OutView.ViewLocation = ViewLocation;
+	OutView.ViewportSize = FVector2D(Canvas->ClipX, Canvas->ClipY);
+	return true;
+}
+
+bool HUDProjection::ProjectToViewport(const FView& View, const FVector& Location, double MaxDistanceSquared, FVector2D& OutScreenPosition)
+{
+	if (FVector::DistSquared(Location, View.ViewLocation) > MaxDistanceSquared)
+	{
+		return false;
+	}
+
+	// W is the depth in front of the view
+	const FVector4 Clip = View.ViewProjection.TransformFVector4(FVector4(Location, 1.0));
+	if (Clip.W <= 0.0)
+	{
+		return false;
+	}
+
+	const double RHW = 1.0 / Clip.W;
+	const FVector2D Screen((0.5 + Clip.X * RHW * 0.5) * View.ViewportSize.X, (0.5 - Clip.Y * RHW * 0.5) * View.ViewportSize.Y);
+	if (Screen.X < 0.0 || Screen.Y < 0.0 || Screen.X > View.ViewportSize.X || Screen.Y > View.ViewportSize.Y)
+	{
+		return false;
+	}
+
+	OutScreenPosition = Screen;
+	return true;
+}
+
+FVector2D HUDProjection::ViewportToLayer(const FVector2D& ScreenPosition, const FGeometry& LayerGeometry)
+{
+	return ScreenPosition / FMath::Max(LayerGeometry.Scale, UE_KINDA_SMALL_NUMBER);
+}
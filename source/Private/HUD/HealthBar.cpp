@@ -1,2 +0,0 @@
-#include "HUD/HealthBar.h"
-
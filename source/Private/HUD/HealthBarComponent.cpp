@@ -1,17 +0,0 @@
-#include "HUD/HealthBarComponent.h"
-#include "HUD/HealthBar.h"
-#include "Components/ProgressBar.h"
-
-void UHealthBarComponent::SetHealthPercent(float Percent)
-{
-	if (HealthBarWidget == nullptr)
-	{
-		HealthBarWidget = Cast<UHealthBar>(GetUserWidgetObject());
-	}
-
-
-	if (HealthBarWidget && HealthBarWidget->HealthBar)
-	{
-		HealthBarWidget->HealthBar->SetPercent(Percent);
-	}
-}
@@ -0,0 +1,202 @@
+#include "HUD/HealthBarSubsystem.h"
+#include "HUD/HUDProjection.h"
+#include "Enemy/Enemy.h"
+#include "Components/AttributeComponent.h"
+#include "Engine/World.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/ProgressBar.h"
+#include "Components/WidgetComponent.h"
+#include "UObject/UObjectIterator.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("HealthBars Project"), STAT_HealthBarsProject, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HealthBars Registered"), STAT_HealthBarsRegistered, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HealthBars Drawn"), STAT_HealthBarsDrawn, STATGROUP_Slash);
+
+void UHealthBarSubsystem::Deinitialize()
+{
+	for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+	{
+		AEnemy* Enemy = Enemies[Index];
+		if (Enemy)
+		{
+			if (Enemy->Attributes)
+			{
+				Enemy->Attributes->OnHealthChanged.Remove(HealthChangedHandles[Index]);
+			}
+			Enemy->HealthBarIndex = INDEX_NONE;
+		}
+	}
+	Enemies.Empty();
+	HeightOffsets.Empty();
+	Percents.Empty();
+	IsShown.Empty();
+	IsEnabled.Empty();
+	HealthChangedHandles.Empty();
+	Super::Deinitialize();
+}
+
+bool UHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+/// <summary>
+/// Starts tracking the enemy's health, hidden until ToggleHealthBar shows it
+/// </summary>
+void UHealthBarSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Enemy->HealthBarIndex != INDEX_NONE || Enemy->Attributes == nullptr)
+	{
+		return;
+	}
+
+	Enemy->HealthBarIndex = Enemies.Add(Enemy);
+	HeightOffsets.Add(Enemy->GetSimpleCollisionHalfHeight() + BarHeightOffset);
+	Percents.Add(Enemy->Attributes->GetHealthPercent());
+	IsShown.Add(false);
+	IsEnabled.Add(true);
+	HealthChangedHandles.Add(Enemy->Attributes->OnHealthChanged.AddUObject(this, &UHealthBarSubsystem::OnHealthChanged, Enemy));
+	SET_DWORD_STAT(STAT_HealthBarsRegistered, Enemies.Num());
+}
+
+void UHealthBarSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->HealthBarIndex) || Enemies[Enemy->HealthBarIndex] != Enemy)
+	{
+		return;
+	}
+
+	const int32 Index = Enemy->HealthBarIndex;
+	if (Enemy->Attributes)
+	{
+		Enemy->Attributes->OnHealthChanged.Remove(HealthChangedHandles[Index]);
+	}
+
+	Enemies.RemoveAtSwap(Index, 1, false);
+	HeightOffsets.RemoveAtSwap(Index, 1, false);
+	Percents.RemoveAtSwap(Index, 1, false);
+	IsShown.RemoveAtSwap(Index, 1, false);
+	IsEnabled.RemoveAtSwap(Index, 1, false);
+	HealthChangedHandles.RemoveAtSwap(Index, 1, false);
+
+	if (Enemies.IsValidIndex(Index))
+	{
+		Enemies[Index]->HealthBarIndex = Index;
+	}
+	Enemy->HealthBarIndex = INDEX_NONE;
+	SET_DWORD_STAT(STAT_HealthBarsRegistered, Enemies.Num());
+}
+
+void UHealthBarSubsystem::SetShown(AEnemy* Enemy, bool bShown)
+{
+	if (Enemy && Enemies.IsValidIndex(Enemy->HealthBarIndex))
+	{
+		IsShown[Enemy->HealthBarIndex] = bShown;
+	}
+}
+
+/// <summary>
+/// Set by the enemy's significance tier, a disabled bar isn't drawn even when shown
+/// </summary>
+void UHealthBarSubsystem::SetEnabled(AEnemy* Enemy, bool bEnabled)
+{
+	if (Enemy && Enemies.IsValidIndex(Enemy->HealthBarIndex))
+	{
+		IsEnabled[Enemy->HealthBarIndex] = bEnabled;
+	}
+}
+
+void UHealthBarSubsystem::OnHealthChanged(float Percent, AEnemy* Enemy)
+{
+	if (Enemies.IsValidIndex(Enemy->HealthBarIndex))
+	{
+		Percents[Enemy->HealthBarIndex] = Percent;
+	}
+}
+
+/// <summary>
+/// Projects every shown, enabled and damaged bar within MaxDrawDistance and keeps the ones on screen
+/// </summary>
+void UHealthBarSubsystem::ProjectBars(const HUDProjection::FView& View, TArray<FHealthBarDraw>& OutBars) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_HealthBarsProject);
+	OutBars.Reset();
+
+	const double MaxDistanceSquared = FMath::Square(MaxDrawDistance);
+	for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+	{
+		if (!IsShown[Index] || !IsEnabled[Index] || Percents[Index] >= 1.f)
+		{
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+		const FVector Location = Enemies[Index]->GetActorLocation() + FVector(0.0, 0.0, HeightOffsets[Index]);
+		if (!HUDProjection::ProjectToViewport(View, Location, MaxDistanceSquared, ScreenPosition))
+		{
+			continue;
+		}
+
+		FHealthBarDraw& Bar = OutBars.AddDefaulted_GetRef();
+		Bar.ScreenPosition = ScreenPosition;
+		Bar.Percent = Percents[Index];
+	}
+	NumDrawnLastFrame = OutBars.Num();
+	SET_DWORD_STAT(STAT_HealthBarsDrawn, OutBars.Num());
+}
+
+/// <summary>
+/// Memory of the registry itself, the bars have no per enemy objects
+/// </summary>
+SIZE_T UHealthBarSubsystem::GetAllocatedSize() const
+{
+	return Enemies.GetAllocatedSize() + HeightOffsets.GetAllocatedSize() + Percents.GetAllocatedSize()
+		+ IsShown.GetAllocatedSize() + IsEnabled.GetAllocatedSize() + HealthChangedHandles.GetAllocatedSize();
+}
+
+/// <summary>
+/// Logs what the health bars cost in this world right now: how many enemies are registered, shown and drawn, the widget
+/// objects that exist for them, and the registry's memory per enemy next to what the removed per enemy UHealthBarComponent
+/// cost. That one is the size of the objects each enemy owned, the widget component, its user widget, widget tree and
+/// progress bar, so it leaves out their Slate widgets and is a lower bound.
+/// Usage: slash.HealthBars.Stats
+/// </summary>
+static void RunHealthBarStats(const TArray<FString>& Args, UWorld* World)
+{
+	const UHealthBarSubsystem* HealthBars = World ? World->GetSubsystem<UHealthBarSubsystem>() : nullptr;
+	if (HealthBars == nullptr)
+	{
+		return;
+	}
+
+	int32 NumWidgetComponents = 0;
+	for (const UWidgetComponent* WidgetComponent : TObjectRange<UWidgetComponent>())
+	{
+		NumWidgetComponents += WidgetComponent->GetWorld() == World ? 1 : 0;
+	}
+	int32 NumUserWidgets = 0;
+	for (const UUserWidget* UserWidget : TObjectRange<UUserWidget>())
+	{
+		NumUserWidgets += UserWidget->GetWorld() == World ? 1 : 0;
+	}
+
+	const int32 NumRegistered = HealthBars->GetNumRegistered();
+	const uint64 RegistryBytes = HealthBars->GetAllocatedSize();
+	const uint64 WidgetComponentBytes = UWidgetComponent::StaticClass()->GetStructureSize() + UUserWidget::StaticClass()->GetStructureSize()
+		+ UWidgetTree::StaticClass()->GetStructureSize() + UProgressBar::StaticClass()->GetStructureSize();
+
+	UE_LOG(LogTemp, Display, TEXT("HealthBars: %d enemies registered, %d bars shown, %d drawn last frame by one SHealthBarLayer"),
+		NumRegistered, HealthBars->GetNumShown(), HealthBars->GetNumDrawnLastFrame());
+	UE_LOG(LogTemp, Display, TEXT("HealthBars: %d widget components and %d user widgets in the world, registry uses %llu bytes"),
+		NumWidgetComponents, NumUserWidgets, RegistryBytes);
+	UE_LOG(LogTemp, Display, TEXT("HealthBars: per enemy %llu bytes in the registry, was at least %llu bytes of widget objects per UHealthBarComponent (%llu for %d enemies)"),
+		NumRegistered > 0 ? RegistryBytes / NumRegistered : 0, WidgetComponentBytes, WidgetComponentBytes * NumRegistered, NumRegistered);
+	UE_LOG(LogTemp, Display, TEXT("HealthBars: per frame cost is 'stat Slash' HealthBars Project plus the layer's paint in 'stat Slate'"));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HealthBarStatsCommand(
+	TEXT("slash.HealthBars.Stats"),
+	TEXT("Logs the health bar counts, widget objects and memory of this world. Usage: slash.HealthBars.Stats"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHealthBarStats));
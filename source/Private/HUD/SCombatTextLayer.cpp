@@ -0,0 +1,47 @@
+#include "HUD/SCombatTextLayer.h"
+#include "HUD/HUDProjection.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontMeasure.h"
+#include "Rendering/DrawElements.h"
+
+void SCombatTextLayer::Construct(const FArguments& InArgs)
+{
+	Font = InArgs._Font;
+	Font.OutlineSettings.OutlineSize = 1;
+	Color = InArgs._Color;
+	Text.Reserve(16);
+}
+
+void SCombatTextLayer::SetDraws(TArray<FCombatTextDraw>& InDraws)
+{
+	if (Draws.Num() == 0 && InDraws.Num() == 0)
+	{
+		return;
+	}
+	Swap(Draws, InDraws);
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+/// <summary>
+/// Each number is measured and centered on its projected point, faded by its age
+/// </summary>
+int32 SCombatTextLayer::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+	int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+	for (const FCombatTextDraw& Draw : Draws)
+	{
+		Text.Reset();
+		Text.AppendInt(Draw.Amount);
+		const FVector2D Size = FontMeasure->Measure(Text, Font);
+		const FVector2D TopLeft = HUDProjection::ViewportToLayer(Draw.ScreenPosition, AllottedGeometry) - Size * 0.5f;
+		FSlateDrawElement::MakeText(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TopLeft)),
+			Text, Font, ESlateDrawEffect::None, Color.CopyWithNewOpacity(Color.A * Draw.Opacity));
+	}
+	return LayerId;
+}
+
+FVector2D SCombatTextLayer::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
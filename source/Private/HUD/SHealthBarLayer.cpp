@@ -0,0 +1,44 @@
+#include "HUD/SHealthBarLayer.h"
+#include "HUD/HUDProjection.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+void SHealthBarLayer::Construct(const FArguments& InArgs)
+{
+	BarSize = InArgs._BarSize;
+	FillColor = InArgs._FillColor;
+	BackgroundColor = InArgs._BackgroundColor;
+	Brush = FCoreStyle::Get().GetBrush("GenericWhiteBox");
+}
+
+void SHealthBarLayer::SetBars(TArray<FHealthBarDraw>& InBars)
+{
+	if (Bars.Num() == 0 && InBars.Num() == 0)
+	{
+		return;
+	}
+	Swap(Bars, InBars);
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+/// <summary>
+/// Each bar is centered on its projected point, background first and the fill over it
+/// </summary>
+int32 SHealthBarLayer::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+	int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	for (const FHealthBarDraw& Bar : Bars)
+	{
+		const FVector2D TopLeft = HUDProjection::ViewportToLayer(Bar.ScreenPosition, AllottedGeometry) - BarSize * 0.5f;
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(BarSize, FSlateLayoutTransform(TopLeft)),
+			Brush, ESlateDrawEffect::None, BackgroundColor);
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(FVector2D(BarSize.X * Bar.Percent, BarSize.Y), FSlateLayoutTransform(TopLeft)),
+			Brush, ESlateDrawEffect::None, FillColor);
+	}
+	return LayerId + 1;
+}
+
+FVector2D SHealthBarLayer::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
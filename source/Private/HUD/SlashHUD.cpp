@@ -1,5 +1,10 @@
 #include "HUD/SlashHUD.h"
 #include "HUD/SlashOverlay.h"
+#include "HUD/SCombatTextLayer.h"
+#include "HUD/SHealthBarLayer.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/GameViewportClient.h"
 
 void ASlashHUD::BeginPlay()
 {
@@ -14,5 +19,71 @@ void ASlashHUD::BeginPlay()
 			SlashOverlay = CreateWidget<USlashOverlay>(Controller, SlashOverlayClass);
 			SlashOverlay->AddToViewport();
 		}
+
+		// Below the overlay
+		if (UGameViewportClient* Viewport = World->GetGameViewport())
+		{
+			Viewport->AddViewportWidgetContent(
+				SAssignNew(HealthBarLayer, SHealthBarLayer)
+				.BarSize(HealthBarSize)
+				.FillColor(HealthBarFillColor)
+				.BackgroundColor(HealthBarBackgroundColor),
+				-1);
+			Viewport->AddViewportWidgetContent(
+				SAssignNew(CombatTextLayer, SCombatTextLayer)
+				.Font(CombatTextFont)
+				.Color(CombatTextColor),
+				-1);
+		}
+	}
+}
+
+void ASlashHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UWorld* World = GetWorld();
+	UGameViewportClient* Viewport = World ? World->GetGameViewport() : nullptr;
+	if (Viewport && HealthBarLayer.IsValid())
+	{
+		Viewport->RemoveViewportWidgetContent(HealthBarLayer.ToSharedRef());
+	}
+	if (Viewport && CombatTextLayer.IsValid())
+	{
+		Viewport->RemoveViewportWidgetContent(CombatTextLayer.ToSharedRef());
+	}
+	HealthBarLayer.Reset();
+	CombatTextLayer.Reset();
+	Super::EndPlay(EndPlayReason);
+}
+
+/// <summary>
+/// Projects the enemy health bars and damage numbers once for the frame and hands them to their layers
+/// </summary>
+void ASlashHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	if (PlayerOwner == nullptr || PlayerOwner->PlayerCameraManager == nullptr)
+	{
+		return;
+	}
+	HUDProjection::FView View;
+	if (!HUDProjection::MakeView(Canvas, PlayerOwner->PlayerCameraManager->GetCameraLocation(), View))
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const UHealthBarSubsystem* HealthBarSubsystem = World->GetSubsystem<UHealthBarSubsystem>();
+	if (HealthBarSubsystem && HealthBarLayer.IsValid())
+	{
+		HealthBarSubsystem->ProjectBars(View, HealthBars);
+		HealthBarLayer->SetBars(HealthBars);
+	}
+
+	const UCombatTextSubsystem* CombatTextSubsystem = World->GetSubsystem<UCombatTextSubsystem>();
+	if (CombatTextSubsystem && CombatTextLayer.IsValid())
+	{
+		CombatTextSubsystem->ProjectText(View, CombatTexts);
+		CombatTextLayer->SetDraws(CombatTexts);
 	}
 }
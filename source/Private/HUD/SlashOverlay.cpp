@@ -1,39 +1,157 @@
 #include "HUD/SlashOverlay.h"
+#include "Components/AttributeComponent.h"
+#include "Components/InvalidationBox.h"
 #include "Components/ProgressBar.h"
 #include "Components/TextBlock.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+// Progress bar changes smaller than this aren't visible
+static constexpr float MinPercentChange = 0.001f;
+
+void USlashOverlay::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+	if (InvalidationRoot)
+	{
+		InvalidationRoot->SetCanCache(true);
+	}
+}
+
+void USlashOverlay::NativeDestruct()
+{
+	UnbindAttributes();
+	Super::NativeDestruct();
+}
+
+/// <summary>
+/// Follows Attributes' change delegates and shows its current values
+/// </summary>
+void USlashOverlay::BindAttributes(UAttributeComponent* Attributes)
+{
+	UnbindAttributes();
+	if (Attributes == nullptr)
+	{
+		return;
+	}
+
+	BoundAttributes = Attributes;
+	HealthChangedHandle = Attributes->OnHealthChanged.AddUObject(this, &USlashOverlay::OnHealthChanged);
+	StaminaChangedHandle = Attributes->OnStaminaChanged.AddUObject(this, &USlashOverlay::OnStaminaChanged);
+	GoldChangedHandle = Attributes->OnGoldChanged.AddUObject(this, &USlashOverlay::OnGoldChanged);
+	SoulsChangedHandle = Attributes->OnSoulsChanged.AddUObject(this, &USlashOverlay::OnSoulsChanged);
+
+	PendingHealthPercent = Attributes->GetHealthPercent();
+	PendingStaminaPercent = Attributes->GetStaminaPercent();
+	PendingCoins = Attributes->GetGold();
+	PendingSouls = Attributes->GetSouls();
+	FlushChanges();
+}
+
+void USlashOverlay::UnbindAttributes()
+{
+	if (UAttributeComponent* Attributes = BoundAttributes.Get())
+	{
+		Attributes->OnHealthChanged.Remove(HealthChangedHandle);
+		Attributes->OnStaminaChanged.Remove(StaminaChangedHandle);
+		Attributes->OnGoldChanged.Remove(GoldChangedHandle);
+		Attributes->OnSoulsChanged.Remove(SoulsChangedHandle);
+	}
+	BoundAttributes.Reset();
+}
 
 void USlashOverlay::SetHealthBarPercent(float Percent)
 {
-	if (HealthProgressBar)
+	if (HealthProgressBar && !FMath::IsNearlyEqual(Percent, ShownHealthPercent, MinPercentChange))
 	{
+		ShownHealthPercent = Percent;
 		HealthProgressBar->SetPercent(Percent);
 	}
 }
 
 void USlashOverlay::SetStaminaBarPercent(float Percent)
 {
-	if (StaminaProgressBar)
+	if (StaminaProgressBar && !FMath::IsNearlyEqual(Percent, ShownStaminaPercent, MinPercentChange))
 	{
+		ShownStaminaPercent = Percent;
 		StaminaProgressBar->SetPercent(Percent);
 	}
 }
 
 void USlashOverlay::SetCoinsValue(int32 Coins)
 {
-	if (CoinsText)
+	if (CoinsText && Coins != ShownCoins)
 	{
-		const FString FormatString = FString::Printf(TEXT("%d"), Coins);
-		FText FormattedText = FText::FromString(FormatString);
-		CoinsText->SetText(FormattedText);
+		ShownCoins = Coins;
+		CoinsText->SetText(FText::AsNumber(Coins, &FNumberFormattingOptions::DefaultNoGrouping()));
 	}
 }
 
 void USlashOverlay::SetSoulsValue(int32 Souls)
 {
-	if (SoulsText)
+	if (SoulsText && Souls != ShownSouls)
 	{
-		const FString FormatString = FString::Printf(TEXT("%d"), Souls);
-		FText FormattedText = FText::FromString(FormatString);
-		SoulsText->SetText(FormattedText);
+		ShownSouls = Souls;
+		SoulsText->SetText(FText::AsNumber(Souls, &FNumberFormattingOptions::DefaultNoGrouping()));
 	}
 }
+
+void USlashOverlay::OnHealthChanged(float Percent)
+{
+	PendingHealthPercent = Percent;
+	RequestFlush();
+}
+
+void USlashOverlay::OnStaminaChanged(float Percent)
+{
+	PendingStaminaPercent = Percent;
+	RequestFlush();
+}
+
+void USlashOverlay::OnGoldChanged(int32 Gold)
+{
+	PendingCoins = Gold;
+	RequestFlush();
+}
+
+void USlashOverlay::OnSoulsChanged(int32 Souls)
+{
+	PendingSouls = Souls;
+	RequestFlush();
+}
+
+/// <summary>
+/// The first change in a frame schedules one flush, the rest only update the pending values
+/// </summary>
+void USlashOverlay::RequestFlush()
+{
+	UWorld* World = GetWorld();
+	if (bFlushRequested || World == nullptr)
+	{
+		return;
+	}
+	bFlushRequested = true;
+	World->GetTimerManager().SetTimerForNextTick(this, &USlashOverlay::FlushChanges);
+}
+
+/// <summary>
+/// Writes the pending values. Stamina regenerates without broadcasting, so while it does the bar reads it again next frame
+/// </summary>
+void USlashOverlay::FlushChanges()
+{
+	bFlushRequested = false;
+
+	if (const UAttributeComponent* Attributes = BoundAttributes.Get())
+	{
+		PendingStaminaPercent = Attributes->GetStaminaPercent();
+		if (Attributes->IsStaminaRegenerating())
+		{
+			RequestFlush();
+		}
+	}
+
+	SetHealthBarPercent(PendingHealthPercent);
+	SetStaminaBarPercent(PendingStaminaPercent);
+	SetCoinsValue(PendingCoins);
+	SetSoulsValue(PendingSouls);
+}
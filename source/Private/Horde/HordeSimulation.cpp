@@ -0,0 +1,215 @@
+#include "Horde/HordeSimulation.h"
+
+FHordeSimulation::FHordeSimulation(int32 Seed)
+	: Random(Seed)
+{
+}
+
+int32 FHordeSimulation::Add(const FVector& Location, float HealthPercent)
+{
+	const int32 Index = Locations.Add(Location);
+	Yaws.Add(Random.FRandRange(-180.f, 180.f));
+	States.Add(EEnemyState::EES_Patrolling);
+	HealthPercents.Add(HealthPercent);
+	Homes.Add(Location);
+	PatrolGoals.Add(Location);
+	Timers.Add(0.f);
+	IsPromoted.Add(false);
+	PatrolGoals[Index] = PickPatrolGoal(Index);
+	return Index;
+}
+
+void FHordeSimulation::RemoveAtSwap(int32 Index)
+{
+	Locations.RemoveAtSwap(Index, 1, false);
+	Yaws.RemoveAtSwap(Index, 1, false);
+	States.RemoveAtSwap(Index, 1, false);
+	HealthPercents.RemoveAtSwap(Index, 1, false);
+	Homes.RemoveAtSwap(Index, 1, false);
+	PatrolGoals.RemoveAtSwap(Index, 1, false);
+	Timers.RemoveAtSwap(Index, 1, false);
+	IsPromoted.RemoveAtSwap(Index, 1, false);
+}
+
+void FHordeSimulation::Reset()
+{
+	Locations.Reset();
+	Yaws.Reset();
+	States.Reset();
+	HealthPercents.Reset();
+	Homes.Reset();
+	PatrolGoals.Reset();
+	Timers.Reset();
+	IsPromoted.Reset();
+}
+
+void FHordeSimulation::Tick(float DeltaTime, const FVector& TargetLocation, bool bHasTarget)
+{
+	if (!bHasTarget)
+	{
+		// TargetLocation is meaningless without a target, chasing it would walk the horde to the world origin
+		ProcessLoseTarget();
+		ProcessPatrol(DeltaTime);
+		return;
+	}
+
+	ProcessPerception(TargetLocation);
+	ProcessPatrol(DeltaTime);
+	ProcessChase(DeltaTime, TargetLocation);
+	ProcessAttack(DeltaTime, TargetLocation);
+}
+
+/// <summary>
+/// Patrolling entities start chasing once the target is within SightRadius. Distance only, no cone or line of sight
+/// </summary>
+void FHordeSimulation::ProcessPerception(const FVector& TargetLocation)
+{
+	const double SightRadiusSq = FMath::Square(Settings.SightRadius);
+	const int32 NumEntities = Num();
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (States[Index] == EEnemyState::EES_Patrolling && !IsPromoted[Index] && FVector::DistSquared2D(Locations[Index], TargetLocation) <= SightRadiusSq)
+		{
+			States[Index] = EEnemyState::EES_Chasing;
+		}
+	}
+}
+
+/// <summary>
+/// Walks to a random point around home, waits like AEnemy does at a patrol marker, then picks the next point
+/// </summary>
+void FHordeSimulation::ProcessPatrol(float DeltaTime)
+{
+	const double PatrolRadiusSq = FMath::Square(Settings.PatrolRadius);
+	const int32 NumEntities = Num();
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (States[Index] != EEnemyState::EES_Patrolling || IsPromoted[Index])
+		{
+			continue;
+		}
+
+		if (Timers[Index] > 0.f)
+		{
+			Timers[Index] -= DeltaTime;
+			continue;
+		}
+
+		if (FVector::DistSquared2D(Locations[Index], PatrolGoals[Index]) <= PatrolRadiusSq)
+		{
+			PatrolGoals[Index] = PickPatrolGoal(Index);
+			Timers[Index] = Random.FRandRange(0.5f, 5.f);
+			continue;
+		}
+		MoveTowards(Index, PatrolGoals[Index], Settings.PatrolWalkSpeed, DeltaTime);
+	}
+}
+
+/// <summary>
+/// Same outcomes as AEnemy::CheckCombatTarget: lose interest outside CombatRadius, start the attack timer inside AttackRadius
+/// </summary>
+void FHordeSimulation::ProcessChase(float DeltaTime, const FVector& TargetLocation)
+{
+	const double CombatRadiusSq = FMath::Square(Settings.CombatRadius);
+	const double AttackRadiusSq = FMath::Square(Settings.AttackRadius);
+	const int32 NumEntities = Num();
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (States[Index] != EEnemyState::EES_Chasing || IsPromoted[Index])
+		{
+			continue;
+		}
+
+		const double DistanceSq = FVector::DistSquared2D(Locations[Index], TargetLocation);
+		if (DistanceSq > CombatRadiusSq)
+		{
+			States[Index] = EEnemyState::EES_Patrolling;
+			Homes[Index] = Locations[Index];
+			PatrolGoals[Index] = PickPatrolGoal(Index);
+		}
+		else if (DistanceSq <= AttackRadiusSq)
+		{
+			States[Index] = EEnemyState::EES_Attacking;
+			Timers[Index] = Settings.AttackDelay;
+		}
+		else
+		{
+			MoveTowards(Index, TargetLocation, Settings.ChaseWalkSpeed, DeltaTime);
+		}
+	}
+}
+
+/// <summary>
+/// Attacking waits for the attack delay, Engaged plays out the attack. Simulated attacks deal no damage,
+/// entities are promoted to AEnemy well before they get into attack range
+/// </summary>
+void FHordeSimulation::ProcessAttack(float DeltaTime, const FVector& TargetLocation)
+{
+	const int32 NumEntities = Num();
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		const EEnemyState State = States[Index];
+		if ((State != EEnemyState::EES_Attacking && State != EEnemyState::EES_Engaged) || IsPromoted[Index])
+		{
+			continue;
+		}
+
+		Yaws[Index] = (TargetLocation - Locations[Index]).Rotation().Yaw;
+		Timers[Index] -= DeltaTime;
+		if (Timers[Index] > 0.f)
+		{
+			continue;
+		}
+
+		if (State == EEnemyState::EES_Attacking)
+		{
+			States[Index] = EEnemyState::EES_Engaged;
+			Timers[Index] = Settings.AttackDuration;
+		}
+		else
+		{
+			States[Index] = EEnemyState::EES_Chasing;
+		}
+	}
+}
+
+/// <summary>
+/// Chasing and attacking entities lose interest where they stand, like ProcessChase does outside CombatRadius
+/// </summary>
+void FHordeSimulation::ProcessLoseTarget()
+{
+	const int32 NumEntities = Num();
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (States[Index] == EEnemyState::EES_Patrolling || IsPromoted[Index])
+		{
+			continue;
+		}
+
+		States[Index] = EEnemyState::EES_Patrolling;
+		Homes[Index] = Locations[Index];
+		PatrolGoals[Index] = PickPatrolGoal(Index);
+		Timers[Index] = 0.f;
+	}
+}
+
+void FHordeSimulation::MoveTowards(int32 Index, const FVector& Goal, float Speed, float DeltaTime)
+{
+	FVector Delta = Goal - Locations[Index];
+	Delta.Z = 0.0;
+	const double Distance = Delta.Size();
+	if (Distance <= UE_KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	const double Step = FMath::Min(static_cast<double>(Speed * DeltaTime), Distance);
+	Locations[Index] += Delta * (Step / Distance);
+	Yaws[Index] = FMath::RadiansToDegrees(FMath::Atan2(Delta.Y, Delta.X));
+}
+
+FVector FHordeSimulation::PickPatrolGoal(int32 Index)
+{
+	const FVector2D Offset = FVector2D(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)).GetSafeNormal() * Random.FRandRange(0.f, Settings.WanderRadius);
+	return Homes[Index] + FVector(Offset, 0.0);
+}
@@ -0,0 +1,330 @@
+#include "Horde/HordeSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Components/AttributeComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/PlayerController.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Slash/SlashBenchmark.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Horde Simulate"), STAT_HordeSimulate, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Horde Promotions"), STAT_HordePromotions, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Horde Instances"), STAT_HordeInstances, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Horde Entities"), STAT_HordeEntities, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Horde Promoted"), STAT_HordePromoted, STATGROUP_Slash);
+
+void UHordeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UActorPoolSubsystem>();
+
+	Simulation.Settings.SightRadius = SightRadius;
+	Simulation.Settings.CombatRadius = CombatRadius;
+}
+
+void UHordeSubsystem::Deinitialize()
+{
+	Simulation.Reset();
+	PromotedEnemies.Empty();
+	NumPromoted = 0;
+	InstanceTransforms.Empty();
+	RenderedStates.Empty();
+	Instances = nullptr;
+	InstanceHost = nullptr;
+	Super::Deinitialize();
+}
+
+bool UHordeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UHordeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHordeSubsystem, STATGROUP_Tickables);
+}
+
+/// <summary>
+/// Adds Count simulated enemies scattered in a disc around Center
+/// </summary>
+void UHordeSubsystem::SpawnHorde(const FVector& Center, double Radius, int32 Count)
+{
+	for (int32 Spawned = 0; Spawned < Count; ++Spawned)
+	{
+		const FVector2D Offset = FMath::RandPointInCircle(Radius);
+		Simulation.Add(Center + FVector(Offset, 0.0));
+		PromotedEnemies.AddDefaulted();
+	}
+}
+
+void UHordeSubsystem::ClearHorde()
+{
+	for (int32 Index = Simulation.Num() - 1; Index >= 0; --Index)
+	{
+		if (PromotedEnemies[Index].IsValid())
+		{
+			Demote(Index);
+		}
+	}
+	Simulation.Reset();
+	PromotedEnemies.Reset();
+	UpdateInstances();
+}
+
+void UHordeSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_HordeEntities, Simulation.Num());
+	if (Simulation.Num() == 0 && InstanceTransforms.Num() == 0)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HordeSimulate);
+		Simulation.Tick(DeltaTime, PlayerPawn ? PlayerPawn->GetActorLocation() : FVector::ZeroVector, PlayerPawn != nullptr);
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HordePromotions);
+		UpdatePromotions(PlayerPawn);
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now >= NextInstanceUpdateTime)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HordeInstances);
+		NextInstanceUpdateTime = Now + InstanceUpdateInterval;
+		UpdateInstances();
+	}
+	SET_DWORD_STAT(STAT_HordePromoted, NumPromoted);
+}
+
+/// <summary>
+/// Promotes the nearby simulated entities while there is room, demotes promoted enemies that walked away,
+/// and drops entities whose enemy died (the corpse stays with the actor pool)
+/// </summary>
+void UHordeSubsystem::UpdatePromotions(APawn* PlayerPawn)
+{
+	const FVector PlayerLocation = PlayerPawn ? PlayerPawn->GetActorLocation() : FVector::ZeroVector;
+	const double PromoteRadiusSq = FMath::Square(PromoteRadius);
+	const double DemoteRadiusSq = FMath::Square(DemoteRadius);
+
+	for (int32 Index = Simulation.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Simulation.IsPromoted[Index])
+		{
+			if (PlayerPawn && NumPromoted < MaxPromoted && FVector::DistSquared2D(Simulation.Locations[Index], PlayerLocation) <= PromoteRadiusSq)
+			{
+				Promote(Index, PlayerPawn);
+			}
+			continue;
+		}
+
+		const AEnemy* Enemy = PromotedEnemies[Index].Get();
+		if (Enemy == nullptr || Enemy->EnemyState == EEnemyState::EES_Dead)
+		{
+			RemoveEntity(Index);
+			continue;
+		}
+
+		Simulation.Locations[Index] = Enemy->GetActorLocation();
+		const bool bOutOfCombat = Enemy->EnemyState <= EEnemyState::EES_Patrolling;
+		if (bOutOfCombat && (PlayerPawn == nullptr || FVector::DistSquared2D(Simulation.Locations[Index], PlayerLocation) > DemoteRadiusSq))
+		{
+			Demote(Index);
+		}
+	}
+}
+
+void UHordeSubsystem::Promote(int32 Index, APawn* PlayerPawn)
+{
+	if (LoadedEnemyClass == nullptr)
+	{
+		LoadedEnemyClass = EnemyClass.LoadSynchronous();
+		if (LoadedEnemyClass == nullptr)
+		{
+			return;
+		}
+	}
+
+	const FTransform Transform(FRotator(0.f, Simulation.Yaws[Index], 0.f), Simulation.Locations[Index]);
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	AEnemy* Enemy = Pool ? Cast<AEnemy>(Pool->AcquireActor(LoadedEnemyClass, Transform)) : nullptr;
+	if (Enemy == nullptr)
+	{
+		return;
+	}
+
+	if (Enemy->Attributes)
+	{
+		Enemy->Attributes->SetHealthPercent(Simulation.HealthPercents[Index]);
+	}
+	if (Simulation.States[Index] >= EEnemyState::EES_Chasing)
+	{
+		Enemy->SetCombatTarget(PlayerPawn);
+	}
+
+	Simulation.IsPromoted[Index] = true;
+	PromotedEnemies[Index] = Enemy;
+	++NumPromoted;
+}
+
+/// <summary>
+/// Copies the enemy back into the simulation, it patrols around where it was demoted
+/// </summary>
+void UHordeSubsystem::Demote(int32 Index)
+{
+	AEnemy* Enemy = PromotedEnemies[Index].Get();
+	if (Enemy)
+	{
+		Simulation.Locations[Index] = Enemy->GetActorLocation();
+		Simulation.Yaws[Index] = Enemy->GetActorRotation().Yaw;
+		Simulation.HealthPercents[Index] = Enemy->Attributes ? Enemy->Attributes->GetHealthPercent() : 1.f;
+
+		if (UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>())
+		{
+			Pool->ReleaseActor(Enemy);
+		}
+	}
+
+	Simulation.States[Index] = EEnemyState::EES_Patrolling;
+	Simulation.Homes[Index] = Simulation.Locations[Index];
+	Simulation.PatrolGoals[Index] = Simulation.Locations[Index];
+	Simulation.Timers[Index] = 0.f;
+	Simulation.IsPromoted[Index] = false;
+	PromotedEnemies[Index] = nullptr;
+	--NumPromoted;
+}
+
+void UHordeSubsystem::RemoveEntity(int32 Index)
+{
+	if (Simulation.IsPromoted[Index])
+	{
+		--NumPromoted;
+	}
+	Simulation.RemoveAtSwap(Index);
+	PromotedEnemies.RemoveAtSwap(Index, 1, false);
+}
+
+/// <summary>
+/// Uploads every entity's transform in one batch. Promoted entities are scaled to zero since their actor is drawn instead.
+/// Custom data 0 holds the EEnemyState for the shared animation, only written when it changed
+/// </summary>
+void UHordeSubsystem::UpdateInstances()
+{
+	if (Instances == nullptr)
+	{
+		UStaticMesh* Mesh = InstanceMesh.LoadSynchronous();
+		if (Mesh == nullptr)
+		{
+			return;
+		}
+
+		InstanceHost = GetWorld()->SpawnActor<AActor>();
+		Instances = NewObject<UInstancedStaticMeshComponent>(InstanceHost);
+		Instances->SetStaticMesh(Mesh);
+		Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instances->SetCanEverAffectNavigation(false);
+		Instances->NumCustomDataFloats = 1;
+		InstanceHost->SetRootComponent(Instances);
+		Instances->RegisterComponent();
+	}
+
+	const int32 NumEntities = Simulation.Num();
+	InstanceTransforms.SetNum(NumEntities, false);
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		InstanceTransforms[Index] = Simulation.IsPromoted[Index]
+			? FTransform(FQuat::Identity, Simulation.Locations[Index], FVector::ZeroVector)
+			: FTransform(FRotator(0.f, Simulation.Yaws[Index], 0.f), Simulation.Locations[Index]);
+	}
+
+	if (Instances->GetInstanceCount() != NumEntities)
+	{
+		Instances->ClearInstances();
+		Instances->AddInstances(InstanceTransforms, false, true);
+		RenderedStates.Init(EEnemyState::EES_MAX, NumEntities);
+	}
+	else
+	{
+		Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, false, true);
+	}
+
+	for (int32 Index = 0; Index < NumEntities; ++Index)
+	{
+		if (RenderedStates[Index] != Simulation.States[Index])
+		{
+			RenderedStates[Index] = Simulation.States[Index];
+			Instances->SetCustomDataValue(Index, 0, static_cast<float>(Simulation.States[Index]), false);
+		}
+	}
+	Instances->MarkRenderStateDirty();
+}
+
+/// <summary>
+/// Spawns a horde around the local player.
+/// Usage: slash.Horde.Spawn [Count] [Radius]
+/// </summary>
+static void RunHordeSpawn(const TArray<FString>& Args, UWorld* World)
+{
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	UHordeSubsystem* Horde = World ? World->GetSubsystem<UHordeSubsystem>() : nullptr;
+	if (PlayerController == nullptr || PlayerController->GetPawn() == nullptr || Horde == nullptr)
+	{
+		return;
+	}
+
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+	const double Radius = Args.Num() > 1 ? FCString::Atod(*Args[1]) : 20000.0;
+	Horde->SpawnHorde(PlayerController->GetPawn()->GetActorLocation(), Radius, Count);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HordeSpawnCommand(
+	TEXT("slash.Horde.Spawn"),
+	TEXT("Spawns simulated horde enemies around the player. Usage: slash.Horde.Spawn [Count] [Radius]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHordeSpawn));
+
+/// <summary>
+/// Ticks a 1k and a 10k horde at the same density against a target circling through them
+/// </summary>
+static void RunHordeBenchmark(int32 NumFrames)
+{
+	const int32 EntityCounts[] = { 1000, 10000 };
+
+	for (const int32 NumEntities : EntityCounts)
+	{
+		// Same density as a 10k horde in a 20000 unit radius
+		const double Radius = 20000.0 * FMath::Sqrt(NumEntities / 10000.0);
+		FHordeSimulation Bench(NumEntities);
+		FRandomStream Stream(NumEntities);
+		for (int32 Index = 0; Index < NumEntities; ++Index)
+		{
+			const FVector2D Offset = FVector2D(Stream.FRandRange(-1.f, 1.f), Stream.FRandRange(-1.f, 1.f)) * Radius;
+			Bench.Add(FVector(Offset, 0.0));
+		}
+
+		FSlashBenchmarkTimer Timer;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double Angle = Frame * SlashBenchmarkDeltaTime * 0.1;
+			const FVector Target(FMath::Cos(Angle) * Radius * 0.5, FMath::Sin(Angle) * Radius * 0.5, 0.0);
+
+			Timer.Begin();
+			Bench.Tick(SlashBenchmarkDeltaTime, Target, true);
+			Timer.End();
+		}
+
+		int32 NumChasing = 0;
+		for (const EEnemyState State : Bench.States)
+		{
+			NumChasing += State >= EEnemyState::EES_Chasing ? 1 : 0;
+		}
+		UE_LOG(LogTemp, Display, TEXT("Horde Benchmark: %d entities, %d frames: %s, %d in combat at the end"),
+			NumEntities, NumFrames, *Timer.ToString(), NumChasing);
+	}
+}
+
+static FSlashBenchmarkCommand HordeBenchmarkCommand(TEXT("Horde"),
+	TEXT("Ticks FHordeSimulation with 1k and 10k entities chasing a moving target"), &RunHordeBenchmark);
@@ -0,0 +1,9 @@
+#include "Interfaces/PoolableInterface.h"
+
+void IPoolableInterface::OnAcquiredFromPool()
+{
+}
+
+void IPoolableInterface::OnReleasedToPool()
+{
+}
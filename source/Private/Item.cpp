@@ -8,6 +8,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"	
 #include "NiagaraComponent.h"
+#include "Pooling/ActorPoolSubsystem.h"
 
 
 AItem::AItem()
@@ -51,6 +52,47 @@ void AItem::SpawnPickupSound()
 	}
 }
 
+/// <summary>
+/// Returns a picked up item to the actor pool, or destroys it when there is no pool
+/// </summary>
+void AItem::ReleaseToPool()
+{
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (Pool)
+	{
+		Pool->ReleaseActor(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+/// <summary>
+/// Restarts hovering from the beginning with the class's default pickup collision and display effect
+/// </summary>
+void AItem::OnAcquiredFromPool()
+{
+	_lifeTime = 0.f;
+	ItemState = EItemState::EIS_Hovering;
+	if (Sphere)
+	{
+		Sphere->SetCollisionEnabled(GetClass()->GetDefaultObject<AItem>()->Sphere->GetCollisionEnabled());
+	}
+	if (DisplayNiagaraComponent)
+	{
+		DisplayNiagaraComponent->Activate(true);
+	}
+}
+
+void AItem::OnReleasedToPool()
+{
+	if (DisplayNiagaraComponent)
+	{
+		DisplayNiagaraComponent->Deactivate();
+	}
+}
+
 float AItem::TransformedSin()
 {
 	return _amplitude * FMath::Sin(_lifeTime * _period);
@@ -0,0 +1,36 @@
+#include "Items/MeleeSweep.h"
+
+/// <summary>
+/// Starts a swing at Pose. The first sample is Pose itself, traced on the next Advance
+/// </summary>
+void FMeleeSweep::Begin(const FMeleeBladePose& Pose, float InSubStepRate)
+{
+	PreviousPose = Pose;
+	PoseTime = 0.0;
+	SubStepRate = FMath::Max(static_cast<double>(InSubStepRate), 1.0);
+	NextSample = 0;
+	HitActors.Reset();
+	bActive = true;
+}
+
+/// <summary>
+/// Stops sampling. The hit set is kept until the next Begin so traces still in flight can't hit the same actor twice
+/// </summary>
+void FMeleeSweep::End()
+{
+	bActive = false;
+}
+
+/// <summary>
+/// Records a hit on the actor for the rest of the swing
+/// </summary>
+/// <returns>False if the actor was already hit this swing, or the swing already hit MaxHitsPerSwing actors</returns>
+bool FMeleeSweep::MarkHit(const AActor* Actor)
+{
+	if (Actor == nullptr || HitActors.Contains(Actor) || HitActors.Num() == MaxHitsPerSwing)
+	{
+		return false;
+	}
+	HitActors.Add(Actor);
+	return true;
+}
@@ -9,7 +9,7 @@ void ASoul::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 		Pickup->PickupSoul(this);
 		SpawnPickupSystem();
 		SpawnPickupSound();
-		Destroy();
+		ReleaseToPool();
 	}
 }
 
@@ -8,7 +8,7 @@ void ATreasure::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 	{
 		Pickup->PickupTreasure(this);
 		SpawnPickupSound();
-		Destroy();
+		ReleaseToPool();
 	}
 }
 
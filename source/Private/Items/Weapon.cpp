@@ -5,7 +5,13 @@
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
 #include "Interfaces/HitInterface.h"
+#include "Components/FactionComponent.h"
+#include "Components/HitboxComponent.h"
 #include "NiagaraComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Combat/WeaponTraceSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 AWeapon::AWeapon()
 {
@@ -18,6 +24,19 @@ AWeapon::AWeapon()
 	WeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	WeaponBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
 	WeaponBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+
+	// The swept blade is read from the owner's animated sockets, so wait for this frame's animation
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+}
+
+void AWeapon::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (MeleeSweep.IsActive())
+	{
+		MeleeSweep.Advance(DeltaTime, GetBladePose(), [this](const FMeleeBladePose& Pose) { TraceMeleeSample(Pose); });
+	}
 }
 
 void AWeapon::BeginPlay()
@@ -27,6 +46,19 @@ void AWeapon::BeginPlay()
 	WeaponBox->OnComponentEndOverlap.AddDynamic(this, &AWeapon::OnWeaponOverlapEnd);
 }
 
+/// <summary>
+/// Drops the weapon from its owner, a reused weapon is equipped again like a fresh one
+/// </summary>
+void AWeapon::OnReleasedToPool()
+{
+	Super::OnReleasedToPool();
+	SetWeaponCollisionEnable(ECollisionEnabled::NoCollision);
+	++SwingId;
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
+}
+
 void AWeapon::Equip(USceneComponent* InParent, FName SocketName, AActor* NewOwner, APawn* NewInstigator)
 {
 	ItemState = EItemState::EIS_Equipped;
@@ -56,9 +88,29 @@ void AWeapon::AttachMeshToSocket(USceneComponent* InParent, const FName& SocketN
 	ItemMesh->AttachToComponent(InParent, TransformRules, SocketName);
 }
 
+/// <summary>
+/// Starts or ends a swing. In sweep mode the blade is traced every sub-step and WeaponBox stays off
+/// </summary>
 void AWeapon::SetWeaponCollisionEnable(ECollisionEnabled::Type CollisionEnabled)
 {
-	if (WeaponBox)
+	const bool bSwingStarting = bSweepMelee ? !MeleeSweep.IsActive() : WeaponBox && WeaponBox->GetCollisionEnabled() == ECollisionEnabled::NoCollision;
+	if (CollisionEnabled != ECollisionEnabled::NoCollision && bSwingStarting)
+	{
+		++SwingId;
+	}
+
+	if (bSweepMelee)
+	{
+		if (CollisionEnabled == ECollisionEnabled::NoCollision)
+		{
+			MeleeSweep.End();
+		}
+		else if (!MeleeSweep.IsActive())
+		{
+			BeginMeleeSweep();
+		}
+	}
+	else if (WeaponBox)
 	{
 		WeaponBox->SetCollisionEnabled(CollisionEnabled);
 	}
@@ -71,34 +123,146 @@ void AWeapon::SetWeaponCollisionEnable(ECollisionEnabled::Type CollisionEnabled)
 
 void AWeapon::OnWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	if (GetOwner()->ActorHasTag(TEXT("Enemy")) && OtherActor->ActorHasTag(TEXT("Enemy")))
+	if (!UFactionComponent::CanDamage(GetOwner(), OtherActor))
 	{
 		return;
 	}
 
+	if (UWeaponTraceSubsystem* WeaponTraces = GetWorld()->GetSubsystem<UWeaponTraceSubsystem>())
+	{
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(WeaponBoxTrace), false, this);
+		Params.AddIgnoredActor(Owner);
+		Params.AddIgnoredActors(ActorsHitThisAttack);
+		WeaponTraces->RequestSweep(this, SwingId, EAsyncTraceType::Single, BoxTraceStart->GetComponentLocation(), BoxTraceEnd->GetComponentLocation(),
+			BoxTraceStart->GetComponentQuat(), FCollisionShape::MakeBox(BoxTraceExtents), Params, FCollisionResponseParams::DefaultResponseParam);
+		return;
+	}
+
 	FHitResult BoxHit;
 	BoxTrace(BoxHit);
 	AActor* HitActor = BoxHit.GetActor();
 	if (HitActor)
 	{
 		ActorsHitThisAttack.AddUnique(HitActor);
-		if (GetOwner()->ActorHasTag(TEXT("Enemy")) && HitActor->ActorHasTag(TEXT("Enemy")))
+		ApplyHit(HitActor, BoxHit);
+	}
+}
+
+/// <summary>
+/// Applies the hits of a trace made earlier in this swing, see UWeaponTraceSubsystem
+/// </summary>
+void AWeapon::ResolveTrace(uint32 TraceSwingId, TArray<FHitResult>& Hits)
+{
+	if (TraceSwingId != SwingId || GetOwner() == nullptr)
+	{
+		return;
+	}
+
+	for (FHitResult& Hit : Hits)
+	{
+		AActor* HitActor = Hit.GetActor();
+		if (bSweepMelee)
+		{
+			if (Cast<IHitInterface>(HitActor) == nullptr || !MeleeSweep.MarkHit(HitActor))
+			{
+				continue;
+			}
+		}
+		else
+		{
+			// Another trace of this swing may have reached the actor first
+			if (HitActor == nullptr || ActorsHitThisAttack.Contains(HitActor))
+			{
+				continue;
+			}
+			ActorsHitThisAttack.Add(HitActor);
+		}
+
+		ApplyHit(HitActor, Hit);
+		// The hit may have pooled this weapon, e.g. by killing an enemy that is recycled right away
+		if (TraceSwingId != SwingId)
 		{
 			return;
 		}
+	}
+}
 
-		// Hit them (play hit reacts etc) FIRST
-		ExecuteOnIHitInterface(HitActor, BoxHit);
+void AWeapon::ApplyHit(AActor* HitActor, FHitResult& Hit)
+{
+	if (!UFactionComponent::CanDamage(GetOwner(), HitActor))
+	{
+		return;
+	}
 
+	AController* InstigatorController = GetInstigator() ? GetInstigator()->Controller : nullptr;
+	const float HitDamage = Damage * UHitboxComponent::GetDamageMultiplier(Hit);
+	if (UDamageQueueSubsystem* DamageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
+	{
+		DamageQueue->QueueHit(HitActor, HitDamage, Hit.ImpactPoint, Owner, InstigatorController, this);
+		if (Cast<IHitInterface>(HitActor))
+		{
+			CreateFields(Hit.ImpactPoint);
+		}
+		return;
+	}
+
+	// Hit them (play hit reacts etc) FIRST
+	ExecuteOnIHitInterface(HitActor, Hit);
 
-		// After they are hit then Apply Damage
-		UGameplayStatics::ApplyDamage(
-			HitActor,
-			Damage,
-			GetInstigator()->Controller,
-			this,
-			UDamageType::StaticClass());
+
+	// After they are hit then Apply Damage
+	UGameplayStatics::ApplyDamage(
+		HitActor,
+		HitDamage,
+		InstigatorController,
+		this,
+		UDamageType::StaticClass());
+}
+
+/// <summary>
+/// The owner's baked trajectory when it has one for this swing, otherwise the animated trace components
+/// </summary>
+FMeleeBladePose AWeapon::GetBladePose() const
+{
+	FMeleeBladePose BakedPose;
+	const ABaseCharacter* Character = Cast<ABaseCharacter>(GetOwner());
+	if (Character && Character->GetBakedBladePose(this, BakedPose))
+	{
+		return BakedPose;
+	}
+	return { BoxTraceStart->GetComponentLocation(), BoxTraceEnd->GetComponentLocation(), BoxTraceStart->GetComponentQuat() };
+}
+
+/// <summary>
+/// Sets up the query once per swing. The trace treats every channel as overlap so one multi-hit trace returns everything
+/// along the blade instead of stopping at the first blocking actor
+/// </summary>
+void AWeapon::BeginMeleeSweep()
+{
+	MeleeQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(WeaponMeleeSweep), false, this);
+	MeleeQueryParams.AddIgnoredActor(GetOwner());
+	MeleeResponseParams.CollisionResponse.SetAllChannels(ECollisionResponse::ECR_Overlap);
+	MeleeSweep.Begin(GetBladePose(), MeleeSubStepRate);
+}
+
+void AWeapon::TraceMeleeSample(const FMeleeBladePose& Pose)
+{
+	if (bShowBoxDebug)
+	{
+		DrawDebugLine(GetWorld(), Pose.Base, Pose.Tip, FColor::Red, false, 5.f);
+	}
+
+	if (UWeaponTraceSubsystem* WeaponTraces = GetWorld()->GetSubsystem<UWeaponTraceSubsystem>())
+	{
+		WeaponTraces->RequestSweep(this, SwingId, EAsyncTraceType::Multi, Pose.Base, Pose.Tip, Pose.Rotation,
+			FCollisionShape::MakeBox(BoxTraceExtents), MeleeQueryParams, MeleeResponseParams);
+		return;
 	}
+
+	MeleeHits.Reset();
+	GetWorld()->SweepMultiByChannel(MeleeHits, Pose.Base, Pose.Tip, Pose.Rotation, ECC_Hitbox,
+		FCollisionShape::MakeBox(BoxTraceExtents), MeleeQueryParams, MeleeResponseParams);
+	ResolveTrace(SwingId, MeleeHits);
 }
 
 void AWeapon::ExecuteOnIHitInterface(AActor* HitActor, FHitResult& BoxHit)
@@ -131,7 +295,7 @@ void AWeapon::BoxTrace(FHitResult& BoxHit)
 	bool bHit = UKismetSystemLibrary::BoxTraceSingle(this, Start, End,
 		BoxTraceExtents,
 		BoxTraceStart->GetComponentRotation(),
-		ETraceTypeQuery::TraceTypeQuery1,
+		UEngineTypes::ConvertToTraceType(ECC_Hitbox),
 		false,
 		ActorsToIgnore,
 		bShowBoxDebug ? EDrawDebugTrace::Type::ForDuration : EDrawDebugTrace::Type::None,
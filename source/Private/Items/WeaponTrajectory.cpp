@@ -0,0 +1,137 @@
+#include "Items/WeaponTrajectory.h"
+#include "Characters/BaseCharacter.h"
+#include "Items/Weapon.h"
+
+#if WITH_EDITOR
+#include "AnimationBlueprintLibrary.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+#endif
+
+/// <summary>
+/// Blade pose Time seconds into Section, in actor space. False past the end of the bake or for sections that weren't baked
+/// </summary>
+bool UWeaponTrajectoryAsset::SampleBlade(FName Section, float Time, FMeleeBladePose& OutPose) const
+{
+	const FWeaponTrajectorySection* Trajectory = Sections.FindByPredicate([Section](const FWeaponTrajectorySection& Baked) { return Baked.Section == Section; });
+	if (Trajectory == nullptr || Trajectory->Samples.Num() == 0 || Time < 0.f)
+	{
+		return false;
+	}
+
+	const int32 LastSample = Trajectory->Samples.Num() - 1;
+	const float SampleTime = Time * Trajectory->SampleRate;
+	if (SampleTime > LastSample)
+	{
+		return false;
+	}
+
+	const int32 Index = FMath::Min(FMath::FloorToInt32(SampleTime), FMath::Max(LastSample - 1, 0));
+	const FWeaponTrajectorySample& From = Trajectory->Samples[Index];
+	const FWeaponTrajectorySample& To = Trajectory->Samples[FMath::Min(Index + 1, LastSample)];
+	const FMeleeBladePose FromPose{ FVector(From.Base), FVector(From.Tip), FQuat(From.Rotation) };
+	const FMeleeBladePose ToPose{ FVector(To.Base), FVector(To.Tip), FQuat(To.Rotation) };
+	OutPose = FMeleeBladePose::Lerp(FromPose, ToPose, FMath::Clamp(SampleTime - Index, 0.f, 1.f));
+	return true;
+}
+
+bool UWeaponTrajectoryAsset::IsBakedFor(const AWeapon* Weapon) const
+{
+	return Weapon && WeaponClass && Weapon->IsA(WeaponClass);
+}
+
+#if WITH_EDITOR
+/// <summary>
+/// Samples the socket's bone through every attack section by walking the reference skeleton and composing the bone poses
+/// of the animation under the montage track, then places the weapon's BoxTraceStart and BoxTraceEnd on the socket
+/// the way AWeapon::AttachMeshToSocket snaps the weapon to it
+/// </summary>
+void UWeaponTrajectoryAsset::Bake()
+{
+	const ABaseCharacter* Character = CharacterClass ? CharacterClass->GetDefaultObject<ABaseCharacter>() : nullptr;
+	const AWeapon* Weapon = WeaponClass ? WeaponClass->GetDefaultObject<AWeapon>() : nullptr;
+	const UAnimMontage* Montage = Character ? Character->GetAttackMontage() : nullptr;
+	const USkeletalMeshComponent* Mesh = Character ? Character->GetMesh() : nullptr;
+	const USkeletalMesh* SkeletalMesh = Mesh ? Mesh->GetSkeletalMeshAsset() : nullptr;
+	const USkeletalMeshSocket* Socket = SkeletalMesh ? SkeletalMesh->FindSocket(SocketName) : nullptr;
+	if (Weapon == nullptr || Montage == nullptr || Socket == nullptr || Montage->SlotAnimTracks.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: needs a character with an attack montage and mesh socket %s, and a weapon"), *GetName(), *SocketName.ToString());
+		return;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+	const int32 SocketBone = RefSkeleton.FindBoneIndex(Socket->BoneName);
+	if (SocketBone == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FTransform SocketToBone = Socket->GetSocketLocalTransform();
+	const FTransform MeshToActor = Mesh->GetRelativeTransform();
+	const FTransform StartToWeapon = Weapon->GetBoxTraceStart()->GetRelativeTransform();
+	const FTransform EndToWeapon = Weapon->GetBoxTraceEnd()->GetRelativeTransform();
+	const FAnimTrack& Track = Montage->SlotAnimTracks[0].AnimTrack;
+
+	Modify();
+	Sections.Reset();
+	for (const FName& SectionName : Character->GetAttackMontageSections())
+	{
+		const int32 SectionIndex = Montage->GetSectionIndex(SectionName);
+		if (SectionIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		float SectionStart = 0.f;
+		float SectionEnd = 0.f;
+		Montage->GetSectionStartAndEndTime(SectionIndex, SectionStart, SectionEnd);
+
+		FWeaponTrajectorySection& Trajectory = Sections.AddDefaulted_GetRef();
+		Trajectory.Section = SectionName;
+		Trajectory.SampleRate = SampleRate;
+		const int32 NumSamples = FMath::FloorToInt32((SectionEnd - SectionStart) * SampleRate) + 1;
+		Trajectory.Samples.Reserve(NumSamples);
+
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			const float TrackTime = FMath::Min(SectionStart + SampleIndex / SampleRate, SectionEnd);
+			const FAnimSegment* Segment = Track.GetSegmentAtTime(TrackTime);
+			const UAnimSequenceBase* Animation = Segment ? Segment->GetAnimReference().Get() : nullptr;
+			if (Animation == nullptr)
+			{
+				Trajectory.Samples.Add(Trajectory.Samples.Num() > 0 ? Trajectory.Samples.Last() : FWeaponTrajectorySample());
+				continue;
+			}
+
+			const float AnimTime = Segment->ConvertTrackPosToAnimPos(TrackTime);
+			const UAnimSequence* Sequence = Cast<UAnimSequence>(Animation);
+			const bool bRootLocked = Sequence && Sequence->bEnableRootMotion;
+
+			// Root motion moves the actor instead, the root bone stays at its reference pose
+			FTransform BoneToMesh = FTransform::Identity;
+			for (int32 Bone = SocketBone; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+			{
+				FTransform BoneToParent = RefSkeleton.GetRefBonePose()[Bone];
+				if (!(bRootLocked && RefSkeleton.GetParentIndex(Bone) == INDEX_NONE))
+				{
+					UAnimationBlueprintLibrary::GetBonePoseForTime(Animation, RefSkeleton.GetBoneName(Bone), AnimTime, false, BoneToParent);
+				}
+				BoneToMesh = BoneToMesh * BoneToParent;
+			}
+
+			const FTransform SocketToActor = SocketToBone * BoneToMesh * MeshToActor;
+			const FTransform Start = StartToWeapon * SocketToActor;
+			FWeaponTrajectorySample& Sample = Trajectory.Samples.AddDefaulted_GetRef();
+			Sample.Base = FVector3f(Start.GetLocation());
+			Sample.Tip = FVector3f((EndToWeapon * SocketToActor).GetLocation());
+			Sample.Rotation = FQuat4f(Start.GetRotation());
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s: baked %d attack sections"), *GetName(), Sections.Num());
+}
+#endif
@@ -0,0 +1,255 @@
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Interfaces/PoolableInterface.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("ActorPool Tick"), STAT_ActorPoolTick, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ActorPool Reused"), STAT_ActorPoolReused, STATGROUP_Slash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ActorPool Spawned"), STAT_ActorPoolSpawned, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ActorPool Corpses"), STAT_ActorPoolCorpses, STATGROUP_Slash);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ActorPool Pending Spawns"), STAT_ActorPoolPendingSpawns, STATGROUP_Slash);
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+	PendingPrewarm.Empty();
+	Corpses.Empty();
+	PendingSpawns.Empty();
+	PendingSpawnsHead = 0;
+	Super::Deinitialize();
+}
+
+bool UActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UActorPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UActorPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (const FActorPoolPrewarm& Entry : Prewarm)
+	{
+		RequestPrewarm(Entry.ActorClass.LoadSynchronous(), Entry.Count);
+	}
+}
+
+/// <summary>
+/// Takes a free actor of the class from the pool, or spawns one when the pool is empty
+/// </summary>
+/// <returns>The actor at Transform, already reset by IPoolableInterface::OnAcquiredFromPool</returns>
+AActor* UActorPoolSubsystem::AcquireActor(UClass* ActorClass, const FTransform& Transform)
+{
+	if (ActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (FActorPool* Pool = Pools.Find(ActorClass))
+	{
+		while (Pool->FreeActors.Num() > 0)
+		{
+			AActor* Actor = Pool->FreeActors.Pop(false);
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			INC_DWORD_STAT(STAT_ActorPoolReused);
+			Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+			SetActorPooled(Actor, false);
+			if (IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor))
+			{
+				Poolable->OnAcquiredFromPool();
+			}
+			return Actor;
+		}
+	}
+
+	// A fresh actor is initialized by its own BeginPlay
+	return SpawnPooledActor(ActorClass, Transform);
+}
+
+/// <summary>
+/// Returns the actor to its class's pool. Actors that can't reset themselves are destroyed instead
+/// </summary>
+void UActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor);
+	if (Poolable == nullptr)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	FActorPool& Pool = Pools.FindOrAdd(Actor->GetClass());
+	if (Pool.FreeActors.Contains(Actor))
+	{
+		return;
+	}
+
+	Poolable->OnReleasedToPool();
+	SetActorPooled(Actor, true);
+	Actor->SetActorLocation(ParkingLocation, false, nullptr, ETeleportType::ResetPhysics);
+	Pool.FreeActors.Add(Actor);
+}
+
+/// <summary>
+/// Queues Count actors of the class to be spawned into the pool, spread over the next frames
+/// </summary>
+void UActorPoolSubsystem::RequestPrewarm(UClass* ActorClass, int32 Count)
+{
+	if (ActorClass == nullptr || Count <= 0)
+	{
+		return;
+	}
+
+	// Keeps the class referenced until it is pre-warmed
+	Pools.FindOrAdd(ActorClass);
+	PendingPrewarm.Emplace(ActorClass, Count);
+}
+
+/// <summary>
+/// Keeps a dead actor visible for LifeSpan seconds before recycling it.
+/// Once MaxVisibleCorpses is exceeded the oldest corpse is recycled right away
+/// </summary>
+void UActorPoolSubsystem::AddCorpse(AActor* Actor, float LifeSpan)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	FCorpse& Corpse = Corpses.AddDefaulted_GetRef();
+	Corpse.Actor = Actor;
+	Corpse.ReleaseTime = GetWorld()->GetTimeSeconds() + LifeSpan;
+
+	while (Corpses.Num() > FMath::Max(MaxVisibleCorpses, 0))
+	{
+		AActor* Oldest = Corpses[0].Actor.Get();
+		Corpses.RemoveAt(0, 1, false);
+		ReleaseActor(Oldest);
+	}
+}
+
+/// <summary>
+/// Queues an acquire for a later frame. Used for loot, which doesn't have to appear on the exact frame it was dropped
+/// </summary>
+void UActorPoolSubsystem::RequestSpawn(UClass* ActorClass, const FTransform& Transform)
+{
+	if (ActorClass == nullptr)
+	{
+		return;
+	}
+
+	// Keeps the class referenced until the request is drained
+	Pools.FindOrAdd(ActorClass);
+	PendingSpawns.Emplace(ActorClass, Transform);
+}
+
+int32 UActorPoolSubsystem::GetNumFree(UClass* ActorClass) const
+{
+	const FActorPool* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->FreeActors.Num() : 0;
+}
+
+void UActorPoolSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActorPoolTick);
+
+	TickPendingSpawns();
+	TickPrewarm();
+	TickCorpses();
+
+	SET_DWORD_STAT(STAT_ActorPoolCorpses, Corpses.Num());
+	SET_DWORD_STAT(STAT_ActorPoolPendingSpawns, PendingSpawns.Num() - PendingSpawnsHead);
+}
+
+/// <summary>
+/// Acquires the oldest spawn requests up to the per frame budget
+/// </summary>
+void UActorPoolSubsystem::TickPendingSpawns()
+{
+	const int32 End = FMath::Min(PendingSpawns.Num(), PendingSpawnsHead + FMath::Max(MaxDeferredSpawnsPerFrame, 1));
+	for (; PendingSpawnsHead < End; ++PendingSpawnsHead)
+	{
+		// Copied, the acquired actor may queue more requests and grow the array
+		const TPair<UClass*, FTransform> Request = PendingSpawns[PendingSpawnsHead];
+		AcquireActor(Request.Key, Request.Value);
+	}
+
+	if (PendingSpawnsHead == PendingSpawns.Num())
+	{
+		PendingSpawns.Reset();
+		PendingSpawnsHead = 0;
+	}
+}
+
+/// <summary>
+/// Spawns and immediately releases queued actors until this frame's budget is used up
+/// </summary>
+void UActorPoolSubsystem::TickPrewarm()
+{
+	if (PendingPrewarm.Num() == 0)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + PrewarmBudgetMs / 1000.0;
+	const FTransform ParkingTransform(ParkingLocation);
+	while (PendingPrewarm.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+	{
+		TPair<UClass*, int32>& Pending = PendingPrewarm[0];
+		if (AActor* Actor = SpawnPooledActor(Pending.Key, ParkingTransform))
+		{
+			ReleaseActor(Actor);
+		}
+		if (--Pending.Value <= 0)
+		{
+			PendingPrewarm.RemoveAt(0, 1, false);
+		}
+	}
+}
+
+/// <summary>
+/// Corpses are kept in death order, so only the front of the list can be due
+/// </summary>
+void UActorPoolSubsystem::TickCorpses()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	while (Corpses.Num() > 0 && Corpses[0].ReleaseTime <= Now)
+	{
+		AActor* Actor = Corpses[0].Actor.Get();
+		Corpses.RemoveAt(0, 1, false);
+		ReleaseActor(Actor);
+	}
+}
+
+AActor* UActorPoolSubsystem::SpawnPooledActor(UClass* ActorClass, const FTransform& Transform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+	if (Actor)
+	{
+		INC_DWORD_STAT(STAT_ActorPoolSpawned);
+	}
+	return Actor;
+}
+
+void UActorPoolSubsystem::SetActorPooled(AActor* Actor, bool bPooled)
+{
+	Actor->SetActorHiddenInGame(bPooled);
+	Actor->SetActorEnableCollision(!bPooled);
+	Actor->SetActorTickEnabled(!bPooled);
+}
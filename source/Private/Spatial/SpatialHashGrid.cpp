@@ -0,0 +1,164 @@
+#include "Spatial/SpatialHashGrid.h"
+
+FSpatialHashGrid::FSpatialHashGrid(double InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0))
+	, InvCellSize(1.0 / FMath::Max(InCellSize, 1.0))
+{
+}
+
+int32 FSpatialHashGrid::Add(const FVector& Location)
+{
+	const int32 Handle = FreeHandles.Num() > 0 ? FreeHandles.Pop(false) : Entries.AddDefaulted();
+	FEntry& Entry = Entries[Handle];
+	Entry.Location = Location;
+	Entry.Cell = GetCell(Location);
+	Entry.CellChangedFrame = GFrameCounter;
+	Entry.bInUse = true;
+	AddToCell(Handle, Entry.Cell);
+	RecordCellChange(Handle);
+	return Handle;
+}
+
+void FSpatialHashGrid::Remove(int32 Handle)
+{
+	if (!IsValidHandle(Handle))
+	{
+		return;
+	}
+
+	// Leaving the grid is a cell change too, whoever watches the handle has to notice it is gone
+	FEntry& Entry = Entries[Handle];
+	RemoveFromCell(Handle, Entry.Cell);
+	Entry = FEntry();
+	FreeHandles.Add(Handle);
+	RecordCellChange(Handle);
+}
+
+/// <summary>
+/// Moves an entry, only touching the cell buckets when it crosses into a new cell
+/// </summary>
+/// <returns>True if the entry changed cell</returns>
+bool FSpatialHashGrid::Update(int32 Handle, const FVector& Location)
+{
+	if (!IsValidHandle(Handle))
+	{
+		return false;
+	}
+
+	FEntry& Entry = Entries[Handle];
+	Entry.Location = Location;
+
+	const FIntPoint NewCell = GetCell(Location);
+	if (NewCell == Entry.Cell)
+	{
+		return false;
+	}
+
+	RemoveFromCell(Handle, Entry.Cell);
+	AddToCell(Handle, NewCell);
+	Entry.Cell = NewCell;
+	Entry.CellChangedFrame = GFrameCounter;
+	RecordCellChange(Handle);
+	return true;
+}
+
+void FSpatialHashGrid::Reset()
+{
+	Entries.Reset();
+	FreeHandles.Reset();
+	Cells.Reset();
+	CellChanges.Reset();
+}
+
+/// <summary>
+/// Gathers every entry within the radius of Center. Only cells overlapping the radius are visited
+/// </summary>
+void FSpatialHashGrid::QueryRadiusSq(const FVector& Center, double RadiusSq, TArray<int32>& OutHandles) const
+{
+	const double Radius = FMath::Sqrt(RadiusSq);
+	const FIntPoint MinCell = GetCell(Center - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Center + FVector(Radius));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<int32>* Bucket = Cells.Find(FIntPoint(X, Y));
+			if (Bucket == nullptr)
+			{
+				continue;
+			}
+
+			for (const int32 Handle : *Bucket)
+			{
+				if (FVector::DistSquared(Entries[Handle].Location, Center) <= RadiusSq)
+				{
+					OutHandles.Add(Handle);
+				}
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Cheap rejection test using only the cells of both entries
+/// </summary>
+/// <returns>False if the entries are guaranteed to be further apart than the radius</returns>
+bool FSpatialHashGrid::MayBeWithinRadiusSq(int32 HandleA, int32 HandleB, double RadiusSq) const
+{
+	return GetCellDistanceLowerBoundSq(Entries[HandleA].Cell, Entries[HandleB].Cell) <= RadiusSq;
+}
+
+double FSpatialHashGrid::GetCellDistanceLowerBoundSq(const FIntPoint& CellA, const FIntPoint& CellB) const
+{
+	const double GapX = FMath::Max(FMath::Abs(CellA.X - CellB.X) - 1, 0) * CellSize;
+	const double GapY = FMath::Max(FMath::Abs(CellA.Y - CellB.Y) - 1, 0) * CellSize;
+	return GapX * GapX + GapY * GapY;
+}
+
+FIntPoint FSpatialHashGrid::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X * InvCellSize), FMath::FloorToInt32(Location.Y * InvCellSize));
+}
+
+bool FSpatialHashGrid::HasCellChangedSince(int32 Handle, uint64 Frame) const
+{
+	return IsValidHandle(Handle) && Entries[Handle].CellChangedFrame >= Frame;
+}
+
+const TArray<int32>& FSpatialHashGrid::GetCellChangesThisFrame() const
+{
+	if (CellChangesFrame != GFrameCounter)
+	{
+		CellChanges.Reset();
+		CellChangesFrame = GFrameCounter;
+	}
+	return CellChanges;
+}
+
+void FSpatialHashGrid::AddToCell(int32 Handle, const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(Handle);
+}
+
+void FSpatialHashGrid::RemoveFromCell(int32 Handle, const FIntPoint& Cell)
+{
+	if (TArray<int32>* Bucket = Cells.Find(Cell))
+	{
+		Bucket->RemoveSingleSwap(Handle, false);
+		if (Bucket->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void FSpatialHashGrid::RecordCellChange(int32 Handle)
+{
+	if (CellChangesFrame != GFrameCounter)
+	{
+		CellChanges.Reset();
+		CellChangesFrame = GFrameCounter;
+	}
+	CellChanges.Add(Handle);
+}
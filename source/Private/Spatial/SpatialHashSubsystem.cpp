@@ -0,0 +1,189 @@
+#include "Spatial/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+#include "Slash/SlashBenchmark.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("SpatialHash Cell Changes"), STAT_SpatialHashCellChanges, STATGROUP_Slash);
+
+void USpatialHashSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Grid = FSpatialHashGrid(CellSize);
+}
+
+void USpatialHashSubsystem::Deinitialize()
+{
+	for (TPair<TObjectKey<AActor>, FTrackedActor>& Pair : TrackedActors)
+	{
+		if (USceneComponent* Root = Pair.Value.Root.Get())
+		{
+			Root->TransformUpdated.Remove(Pair.Value.TransformUpdatedHandle);
+		}
+	}
+	TrackedActors.Empty();
+	Grid.Reset();
+	Super::Deinitialize();
+}
+
+bool USpatialHashSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+/// <summary>
+/// Starts tracking the actor, or adds a reference if it is already tracked
+/// </summary>
+/// <returns>Grid handle for the actor</returns>
+int32 USpatialHashSubsystem::RegisterActor(AActor* Actor)
+{
+	if (Actor == nullptr || Actor->GetRootComponent() == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	FTrackedActor& Tracked = TrackedActors.FindOrAdd(Actor);
+	if (Tracked.RefCount++ == 0)
+	{
+		USceneComponent* Root = Actor->GetRootComponent();
+		Tracked.Handle = Grid.Add(Actor->GetActorLocation());
+		Tracked.Root = Root;
+		Tracked.TransformUpdatedHandle = Root->TransformUpdated.AddUObject(this, &USpatialHashSubsystem::OnTransformUpdated, Tracked.Handle);
+		INC_DWORD_STAT(STAT_SpatialHashCellChanges);
+	}
+	return Tracked.Handle;
+}
+
+/// <summary>
+/// Releases a reference to the actor, removing it from the grid when nobody uses it anymore
+/// </summary>
+void USpatialHashSubsystem::UnregisterActor(AActor* Actor)
+{
+	FTrackedActor* Tracked = TrackedActors.Find(Actor);
+	if (Tracked == nullptr || --Tracked->RefCount > 0)
+	{
+		return;
+	}
+
+	if (USceneComponent* Root = Tracked->Root.Get())
+	{
+		Root->TransformUpdated.Remove(Tracked->TransformUpdatedHandle);
+	}
+	Grid.Remove(Tracked->Handle);
+	INC_DWORD_STAT(STAT_SpatialHashCellChanges);
+	TrackedActors.Remove(Actor);
+}
+
+int32 USpatialHashSubsystem::FindHandle(const AActor* Actor) const
+{
+	const FTrackedActor* Tracked = TrackedActors.Find(Actor);
+	return Tracked ? Tracked->Handle : INDEX_NONE;
+}
+
+/// <summary>
+/// Exact squared distance check that is skipped entirely when the grid cells are already too far apart
+/// </summary>
+bool USpatialHashSubsystem::IsWithinRadiusSq(int32 HandleA, int32 HandleB, double RadiusSq) const
+{
+	if (!Grid.IsValidHandle(HandleA) || !Grid.IsValidHandle(HandleB) || !Grid.MayBeWithinRadiusSq(HandleA, HandleB, RadiusSq))
+	{
+		return false;
+	}
+	return FVector::DistSquared(Grid.GetLocation(HandleA), Grid.GetLocation(HandleB)) <= RadiusSq;
+}
+
+void USpatialHashSubsystem::OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Handle)
+{
+	if (Grid.Update(Handle, UpdatedComponent->GetComponentLocation()))
+	{
+		INC_DWORD_STAT(STAT_SpatialHashCellChanges);
+	}
+}
+
+/// <summary>
+/// Compares the grid against the brute force distance test on random actors. Every frame a tenth of the actors move, one in a
+/// hundred leave and are replaced, and QueriesPerFrame radius queries run both ways. The grid's upkeep is timed on its own and
+/// its cell changes counted the way GetCellChangesThisFrame records them, moves across cells, adds and removes
+/// </summary>
+static void RunSpatialHashBenchmark(int32 NumFrames)
+{
+	const int32 QueriesPerFrame = 100;
+	const double QueryRadius = 500.0;
+	const int32 ActorCounts[] = { 100, 1000, 10000 };
+
+	for (const int32 NumActors : ActorCounts)
+	{
+		// Keep roughly constant density so the grid sees a realistic number of actors per cell
+		const double Extent = FMath::Sqrt(static_cast<double>(NumActors)) * 400.0;
+		FRandomStream Stream(NumActors);
+		auto RandomLocation = [&Stream, Extent]() { return FVector(Stream.FRandRange(-Extent, Extent), Stream.FRandRange(-Extent, Extent), 0.0); };
+
+		TArray<FVector> Locations;
+		TArray<int32> Handles;
+		Locations.Reserve(NumActors);
+		Handles.Reserve(NumActors);
+		FSpatialHashGrid BenchGrid(500.0);
+		for (int32 Index = 0; Index < NumActors; ++Index)
+		{
+			Locations.Add(RandomLocation());
+			Handles.Add(BenchGrid.Add(Locations.Last()));
+		}
+
+		FSlashBenchmarkTimer UpkeepTimer;
+		FSlashBenchmarkTimer BruteForceTimer;
+		FSlashBenchmarkTimer GridTimer;
+		int64 NumCellChanges = 0;
+		int64 BruteForceHits = 0;
+		int64 GridHits = 0;
+		TArray<FVector> QueryCenters;
+		TArray<int32> Results;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			UpkeepTimer.Begin();
+			for (int32 Index = Frame % 10; Index < NumActors; Index += 10)
+			{
+				// About a frame of running at a few hundred units per second
+				Locations[Index] += FVector(Stream.FRandRange(-8.0, 8.0), Stream.FRandRange(-8.0, 8.0), 0.0);
+				NumCellChanges += BenchGrid.Update(Handles[Index], Locations[Index]) ? 1 : 0;
+			}
+			for (int32 Index = Frame % 100; Index < NumActors; Index += 100)
+			{
+				BenchGrid.Remove(Handles[Index]);
+				Locations[Index] = RandomLocation();
+				Handles[Index] = BenchGrid.Add(Locations[Index]);
+				NumCellChanges += 2;
+			}
+			UpkeepTimer.End();
+
+			QueryCenters.Reset();
+			for (int32 Query = 0; Query < QueriesPerFrame; ++Query)
+			{
+				QueryCenters.Add(RandomLocation());
+			}
+
+			BruteForceTimer.Begin();
+			for (const FVector& Center : QueryCenters)
+			{
+				for (const FVector& Location : Locations)
+				{
+					// Matches the old AEnemy::InTargetRange which took the full square root
+					BruteForceHits += (Location - Center).Size() <= QueryRadius ? 1 : 0;
+				}
+			}
+			BruteForceTimer.End();
+
+			GridTimer.Begin();
+			for (const FVector& Center : QueryCenters)
+			{
+				Results.Reset();
+				BenchGrid.QueryRadiusSq(Center, FMath::Square(QueryRadius), Results);
+				GridHits += Results.Num();
+			}
+			GridTimer.End();
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("SpatialHash Benchmark: %d actors, %d queries/frame, %d frames: brute force %s (%lld hits), grid %s (%lld hits), grid upkeep %s, %.1f cell changes per frame"),
+			NumActors, QueriesPerFrame, NumFrames, *BruteForceTimer.ToString(), BruteForceHits, *GridTimer.ToString(), GridHits, *UpkeepTimer.ToString(),
+			static_cast<double>(NumCellChanges) / NumFrames);
+	}
+}
+
+static FSlashBenchmarkCommand SpatialHashBenchmarkCommand(TEXT("SpatialHash"), TEXT("Compares FSpatialHashGrid radius queries and upkeep against brute force distance checks at 100, 1k and 10k actors"), &RunSpatialHashBenchmark);
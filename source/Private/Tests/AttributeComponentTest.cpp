@@ -0,0 +1,115 @@
+#include "Misc/AutomationTest.h"
+#include "Components/AttributeComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStaminaRegenTest, "Slash.Components.Attributes.StaminaRegen",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace StaminaRegenTest
+{
+	const float MaxStamina = 100.f;
+	const float RechargeRate = 8.f;
+	const float MidRegenCost = 30.f;
+
+	void Override(UAttributeComponent* Attributes, EModifiedAttribute Attribute, float Value)
+	{
+		FAttributeModifier Modifier;
+		Modifier.Attribute = Attribute;
+		Modifier.Op = EModifierOp::EMO_Override;
+		Modifier.Magnitude = Value;
+		Attributes->AddModifier(Modifier);
+	}
+
+	float NextDeltaTime(float FrameRate, FRandomStream& Stream)
+	{
+		// Zero is jittered frame times between 5 and 50 ms
+		return FrameRate > 0.f ? 1.f / FrameRate : Stream.FRandRange(0.005f, 0.05f);
+	}
+}
+
+/// <summary>
+/// Empties a UAttributeComponent's stamina in a test world and ticks the world until a second after it is full again, spending
+/// MidRegenCost halfway. Every frame GetStamina has to match the per frame clamped regeneration the component used to tick, and
+/// the full timer has to broadcast OnStaminaChanged once at 100%.
+/// Power of two frame rates keep every frame time and sum exact in floats, so those must match exactly. At the others the per
+/// frame sum rounds on every add, by at most half an ulp of a value no larger than MaxStamina, so it may drift from the
+/// analytic value by that much per frame and no more
+/// </summary>
+bool FStaminaRegenTest::RunTest(const FString& Parameters)
+{
+	using namespace StaminaRegenTest;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	AActor* Owner = World->SpawnActor<AActor>();
+	UAttributeComponent* Attributes = NewObject<UAttributeComponent>(Owner);
+	Attributes->RegisterComponent();
+	Override(Attributes, EModifiedAttribute::EMA_MaxStamina, MaxStamina);
+	Override(Attributes, EModifiedAttribute::EMA_StaminaRechargeRate, RechargeRate);
+
+	int32 NumFullBroadcasts = 0;
+	float LastBroadcastPercent = -1.f;
+	Attributes->OnStaminaChanged.AddLambda([&](float Percent)
+	{
+		LastBroadcastPercent = Percent;
+		NumFullBroadcasts += Percent == 1.f ? 1 : 0;
+	});
+
+	const double Duration = (MaxStamina + MidRegenCost) / RechargeRate + 1.0;
+	const float FrameRates[] = { 16.f, 64.f, 256.f, 30.f, 60.f, 144.f, 0.f };
+	for (const float FrameRate : FrameRates)
+	{
+		const bool bExact = FrameRate > 0.f && FMath::IsPowerOfTwo(static_cast<uint32>(FrameRate));
+		const FString Rate = FrameRate > 0.f ? FString::Printf(TEXT("%.0f FPS"), FrameRate) : FString(TEXT("jittered frames"));
+
+		Attributes->UseStamina(MaxStamina);
+		NumFullBroadcasts = 0;
+
+		FRandomStream Stream(1234);
+		const double StartTime = World->GetTimeSeconds();
+		float Ticked = 0.f;
+		float MaxError = 0.f;
+		int32 NumFrames = 0;
+		bool bSpent = false;
+		while (World->GetTimeSeconds() - StartTime < Duration)
+		{
+			const float DeltaTime = NextDeltaTime(FrameRate, Stream);
+			// The timer manager ticks once per engine frame
+			++GFrameCounter;
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++NumFrames;
+
+			// The removed TickComponent
+			if (Ticked < MaxStamina)
+			{
+				Ticked = FMath::Clamp(Ticked + RechargeRate * DeltaTime, 0.f, MaxStamina);
+			}
+			MaxError = FMath::Max(MaxError, FMath::Abs(Attributes->GetStamina() - Ticked));
+
+			if (!bSpent && World->GetTimeSeconds() - StartTime >= 0.5 * MaxStamina / RechargeRate)
+			{
+				Attributes->UseStamina(MidRegenCost);
+				Ticked = FMath::Clamp(Ticked - MidRegenCost, 0.f, MaxStamina);
+				bSpent = true;
+			}
+		}
+
+		const float Tolerance = bExact ? 0.f : NumFrames * 0.5f * MaxStamina * FLT_EPSILON;
+		TestTrue(FString::Printf(TEXT("Stamina at %s within %g of per frame regeneration, max error %g"), *Rate, Tolerance, MaxError), MaxError <= Tolerance);
+		TestEqual(FString::Printf(TEXT("Stamina at %s after regenerating"), *Rate), Attributes->GetStamina(), MaxStamina);
+		TestEqual(FString::Printf(TEXT("Full broadcasts at %s"), *Rate), NumFullBroadcasts, 1);
+		TestEqual(FString::Printf(TEXT("Last broadcast percent at %s"), *Rate), LastBroadcastPercent, 1.f);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
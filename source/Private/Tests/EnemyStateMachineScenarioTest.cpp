@@ -0,0 +1,480 @@
+#include "Misc/AutomationTest.h"
+#include "Enemy/EnemyStateMachine.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyStateMachineScenarioTest, "Slash.Enemy.StateMachine.ScenarioReplay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace EnemyScenarioTest
+{
+	// Enemy and targets move along a line, patrol markers at 0 and 1000
+	const double PatrolRadius = 200.0;
+	const double CombatRadius = 500.0;
+	const double AttackRadius = 150.0;
+	const double Markers[] = { 0.0, 1000.0 };
+	// In frames
+	const int32 PatrolDelay = 3;
+	const int32 AttackDelay = 4;
+
+	enum class EAction : uint8
+	{
+		None,
+		MoveEnemy,		// Value is the enemy's new position
+		MoveTarget,		// Value is the combat target's new position
+		SeeTarget,		// OnPawnSeen with the target at Value
+		AttackEnd,		// The attack montage's AttackEnd notify
+		GetHit,
+		Die,
+		Stun,			// Pauses the timers and drops the AI events until Unstun
+		Unstun
+	};
+
+	struct FStep
+	{
+		EAction Action = EAction::None;
+		double Value = 0.0;
+	};
+
+	/**
+	 * The parts of AEnemy the decisions read and write, without a world. Both drivers share CheckPatrolTarget and CheckCombatTarget,
+	 * the decisions themselves didn't change; what differs is when they run. The polling driver is the AEnemy::Tick the transition
+	 * table replaced, the event driven one raises the same events AEnemy and UEnemyAIManager do and lets the table pick the reaction.
+	 * A stun freezes both, the polling one just skips its ticks until the stun ends
+	 */
+	struct FScenarioEnemy
+	{
+		explicit FScenarioEnemy(bool bInEventDriven)
+			: bEventDriven(bInEventDriven)
+		{
+		}
+
+		bool bEventDriven;
+		EEnemyState State = EEnemyState::EES_Idle;
+		bool bHasCombatTarget = false;
+		double Location = 0.0;
+		double TargetLocation = 0.0;
+		int32 PatrolIndex = 0;
+		int32 PatrolTimer = 0;
+		int32 AttackTimer = 0;
+		bool bStunned = false;
+		// MoveToTarget calls on the patrol target, by the patrol timer or on losing interest
+		int32 NumPatrolMoves = 0;
+		// Last flags UEnemyAIManager dispatched, unset until the first update
+		TOptional<EEnemyRangeFlags> RangeFlags;
+		TArray<FString> Violations;
+
+		bool IsOutsideCombatRadius() const { return !bHasCombatTarget || FMath::Abs(TargetLocation - Location) > CombatRadius; }
+		bool IsOutsideAttackRadius() const { return !bHasCombatTarget || FMath::Abs(TargetLocation - Location) > AttackRadius; }
+		bool IsInPatrolRange() const { return FMath::Abs(Markers[PatrolIndex] - Location) <= PatrolRadius; }
+
+		void StartAttackTimer()
+		{
+			State = EEnemyState::EES_Attacking;
+			AttackTimer = AttackDelay;
+		}
+
+		// GetPatrolTarget always picks the other marker here
+		void CheckPatrolTarget(bool bInPatrolRange)
+		{
+			State = EEnemyState::EES_Patrolling;
+			if (bInPatrolRange)
+			{
+				PatrolIndex = 1 - PatrolIndex;
+				PatrolTimer = PatrolDelay;
+			}
+		}
+
+		void CheckCombatTarget(bool bOutsideCombatRadius, bool bOutsideAttackRadius)
+		{
+			if (bOutsideCombatRadius)
+			{
+				AttackTimer = 0;
+				bHasCombatTarget = false;
+				if (State != EEnemyState::EES_Engaged)
+				{
+					// StartPatrolling
+					State = EEnemyState::EES_Patrolling;
+					++NumPatrolMoves;
+				}
+			}
+			else if (State != EEnemyState::EES_Chasing && bOutsideAttackRadius)
+			{
+				AttackTimer = 0;
+				if (State != EEnemyState::EES_Engaged)
+				{
+					State = EEnemyState::EES_Chasing;
+				}
+			}
+			else if (State < EEnemyState::EES_Attacking && !bOutsideAttackRadius && State != EEnemyState::EES_Dead)
+			{
+				StartAttackTimer();
+			}
+		}
+
+		/// <summary>
+		/// AEnemy::HandleEnemyEvent, recording every result the table doesn't allow
+		/// </summary>
+		void HandleEvent(EEnemyEvent Event, TOptional<EEnemyRangeFlags> Flags = TOptional<EEnemyRangeFlags>())
+		{
+			if (bStunned)
+			{
+				return;
+			}
+
+			const EEnemyState FromState = State;
+			const EnemyStateMachine::FTransition& Transition = EnemyStateMachine::GetTransition(FromState, Event);
+			switch (Transition.Reaction)
+			{
+			case EEnemyReaction::EER_EvaluatePatrol:
+				CheckPatrolTarget(Flags.IsSet() ? EnumHasAnyFlags(Flags.GetValue(), EEnemyRangeFlags::InPatrolRange) : IsInPatrolRange());
+				break;
+			case EEnemyReaction::EER_EvaluateCombat:
+				CheckCombatTarget(Flags.IsSet() ? !EnumHasAnyFlags(Flags.GetValue(), EEnemyRangeFlags::InCombatRadius) : IsOutsideCombatRadius(),
+					Flags.IsSet() ? !EnumHasAnyFlags(Flags.GetValue(), EEnemyRangeFlags::InAttackRadius) : IsOutsideAttackRadius());
+				break;
+			default:
+				break;
+			}
+
+			if (!Transition.Allows(State))
+			{
+				Violations.Add(FString::Printf(TEXT("state %d on event %d went to state %d"), static_cast<int32>(FromState), static_cast<int32>(Event), static_cast<int32>(State)));
+			}
+		}
+
+		void Apply(const FStep& Step)
+		{
+			switch (Step.Action)
+			{
+			case EAction::MoveEnemy:
+				Location = Step.Value;
+				break;
+			case EAction::MoveTarget:
+				TargetLocation = Step.Value;
+				break;
+			case EAction::SeeTarget:
+				SeeTarget(Step.Value);
+				break;
+			case EAction::AttackEnd:
+				AttackEnd();
+				break;
+			case EAction::GetHit:
+				GetHit();
+				break;
+			case EAction::Die:
+				State = EEnemyState::EES_Dead;
+				AttackTimer = 0;
+				if (bEventDriven)
+				{
+					HandleEvent(EEnemyEvent::EEE_Die);
+				}
+				break;
+			case EAction::Stun:
+				bStunned = true;
+				break;
+			case EAction::Unstun:
+				Unstun();
+				break;
+			default:
+				break;
+			}
+		}
+
+		// OnPawnSeen, then SetCombatTarget as it was before the table and as it is now
+		void SeeTarget(double InTargetLocation)
+		{
+			TargetLocation = InTargetLocation;
+			if (State >= EEnemyState::EES_Chasing || State == EEnemyState::EES_Dead)
+			{
+				return;
+			}
+
+			if (bEventDriven)
+			{
+				if (EnemyStateMachine::GetTransition(State, EEnemyEvent::EEE_TargetAcquired).Reaction == EEnemyReaction::EER_Ignore)
+				{
+					return;
+				}
+				bHasCombatTarget = true;
+				if (bStunned)
+				{
+					return;
+				}
+				PatrolTimer = 0;
+				HandleEvent(EEnemyEvent::EEE_TargetAcquired);
+				return;
+			}
+
+			bHasCombatTarget = true;
+			if (!IsOutsideAttackRadius())
+			{
+				State = EEnemyState::EES_Attacking;
+			}
+			else
+			{
+				PatrolTimer = 0;
+				State = EEnemyState::EES_Chasing;
+			}
+		}
+
+		void AttackEnd()
+		{
+			if (bEventDriven)
+			{
+				if (State != EEnemyState::EES_Dead)
+				{
+					State = EEnemyState::EES_Idle;
+					HandleEvent(EEnemyEvent::EEE_AttackEnd);
+				}
+				return;
+			}
+			State = EEnemyState::EES_Idle;
+			CheckCombatTarget(IsOutsideCombatRadius(), IsOutsideAttackRadius());
+		}
+
+		void GetHit()
+		{
+			PatrolTimer = 0;
+			AttackTimer = 0;
+			if (!IsOutsideAttackRadius())
+			{
+				StartAttackTimer();
+			}
+			if (bEventDriven)
+			{
+				HandleEvent(EEnemyEvent::EEE_GetHit);
+			}
+		}
+
+		// AEnemy::SetStatusEffects, a target held while idle or patrolling is acquired instead
+		void Unstun()
+		{
+			bStunned = false;
+			if (!bEventDriven)
+			{
+				return;
+			}
+			if (bHasCombatTarget && (State == EEnemyState::EES_Idle || State == EEnemyState::EES_Patrolling))
+			{
+				PatrolTimer = 0;
+				HandleEvent(EEnemyEvent::EEE_TargetAcquired);
+				return;
+			}
+			HandleEvent(EEnemyEvent::EEE_StunEnded);
+		}
+
+		// PatrolTimerFinished only starts a move, Attack engages. Both timers are paused while stunned
+		void AdvanceTimers()
+		{
+			if (bStunned)
+			{
+				return;
+			}
+			if (PatrolTimer > 0 && --PatrolTimer == 0)
+			{
+				++NumPatrolMoves;
+				if (bEventDriven)
+				{
+					HandleEvent(EEnemyEvent::EEE_PatrolTimerExpired);
+				}
+			}
+			if (AttackTimer > 0 && --AttackTimer == 0)
+			{
+				State = EEnemyState::EES_Engaged;
+				if (bEventDriven)
+				{
+					HandleEvent(EEnemyEvent::EEE_AttackTimerExpired);
+				}
+			}
+		}
+
+		/// <summary>
+		/// The polling driver runs the old AEnemy::Tick. The event driven one runs UEnemyAIManager::UpdateEnemy, which measures
+		/// the same target Tick did and raises EEE_RangeChanged only when a flag flipped or the enemy stands at its patrol marker
+		/// </summary>
+		void Decide()
+		{
+			if (State == EEnemyState::EES_Dead)
+			{
+				return;
+			}
+
+			const bool bCombat = State > EEnemyState::EES_Patrolling;
+			if (!bEventDriven)
+			{
+				if (bStunned)
+				{
+					return;
+				}
+				if (bCombat)
+				{
+					CheckCombatTarget(IsOutsideCombatRadius(), IsOutsideAttackRadius());
+				}
+				else
+				{
+					CheckPatrolTarget(IsInPatrolRange());
+				}
+				return;
+			}
+
+			EEnemyRangeFlags Flags = EEnemyRangeFlags::None;
+			if (!bCombat || bHasCombatTarget)
+			{
+				const double Distance = FMath::Abs((bCombat ? TargetLocation : Markers[PatrolIndex]) - Location);
+				Flags |= Distance <= PatrolRadius ? EEnemyRangeFlags::InPatrolRange : EEnemyRangeFlags::None;
+				Flags |= Distance <= CombatRadius ? EEnemyRangeFlags::InCombatRadius : EEnemyRangeFlags::None;
+				Flags |= Distance <= AttackRadius ? EEnemyRangeFlags::InAttackRadius : EEnemyRangeFlags::None;
+			}
+			const bool bAtPatrolMarker = !bCombat && EnumHasAnyFlags(Flags, EEnemyRangeFlags::InPatrolRange);
+			const bool bChanged = !RangeFlags.IsSet() || RangeFlags.GetValue() != Flags;
+			RangeFlags = Flags;
+			if (bChanged || bAtPatrolMarker)
+			{
+				HandleEvent(EEnemyEvent::EEE_RangeChanged, Flags);
+			}
+		}
+
+		// One frame: scripted actions, then timers, then the AI update
+		void Frame(const FStep& Step)
+		{
+			Apply(Step);
+			AdvanceTimers();
+			Decide();
+		}
+	};
+
+	using EState = EEnemyState;
+
+	// Patrol to the far marker and back, spot the player, attack twice with a hit and an AttackEnd in between, lose the attack range
+	// and get it back, lose the player, spot them again and die
+	const FStep FightScript[] =
+	{
+		{}, {}, {}, {},
+		{ EAction::MoveEnemy, 500.0 },
+		{ EAction::MoveEnemy, 900.0 },
+		{},
+		{ EAction::SeeTarget, 1200.0 },
+		{ EAction::MoveEnemy, 1100.0 },
+		{}, {}, {}, {},
+		{ EAction::GetHit },
+		{}, {}, {}, {},
+		{ EAction::AttackEnd },
+		{ EAction::MoveTarget, 1400.0 },
+		{ EAction::MoveTarget, 1200.0 },
+		{}, {}, {}, {},
+		{ EAction::AttackEnd },
+		{ EAction::MoveTarget, 2000.0 },
+		{},
+		{ EAction::SeeTarget, 1300.0 },
+		{ EAction::Die },
+		{},
+	};
+
+	// What the old Tick ended each frame of FightScript in
+	const EState FightExpected[] =
+	{
+		EState::EES_Patrolling, EState::EES_Patrolling, EState::EES_Patrolling, EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Chasing,
+		EState::EES_Attacking,
+		EState::EES_Attacking, EState::EES_Attacking, EState::EES_Attacking, EState::EES_Engaged,
+		EState::EES_Attacking,
+		EState::EES_Attacking, EState::EES_Attacking, EState::EES_Engaged, EState::EES_Engaged,
+		EState::EES_Attacking,
+		EState::EES_Chasing,
+		EState::EES_Attacking,
+		EState::EES_Attacking, EState::EES_Attacking, EState::EES_Attacking, EState::EES_Engaged,
+		EState::EES_Attacking,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Chasing,
+		EState::EES_Dead,
+		EState::EES_Dead,
+	};
+	static_assert(UE_ARRAY_COUNT(FightScript) == UE_ARRAY_COUNT(FightExpected), "One expected state per scripted frame");
+
+	// Stunned at a patrol marker while the patrol timer runs, then mid attack while the player runs out of the combat radius
+	const FStep StunScript[] =
+	{
+		{},
+		{ EAction::Stun },
+		{}, {},
+		{ EAction::Unstun },
+		{}, {},
+		{ EAction::MoveEnemy, 500.0 },
+		{ EAction::MoveEnemy, 900.0 },
+		{},
+		{ EAction::SeeTarget, 1200.0 },
+		{ EAction::MoveEnemy, 1100.0 },
+		{},
+		{ EAction::Stun },
+		{ EAction::MoveTarget, 2000.0 },
+		{},
+		{ EAction::Unstun },
+		{}, {},
+	};
+
+	const EState StunExpected[] =
+	{
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling, EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling, EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling,
+		EState::EES_Chasing,
+		EState::EES_Attacking,
+		EState::EES_Attacking,
+		EState::EES_Attacking,
+		EState::EES_Attacking,
+		EState::EES_Attacking,
+		EState::EES_Patrolling,
+		EState::EES_Patrolling, EState::EES_Patrolling,
+	};
+	static_assert(UE_ARRAY_COUNT(StunScript) == UE_ARRAY_COUNT(StunExpected), "One expected state per scripted frame");
+
+	/// <summary>
+	/// Runs Script through both drivers. Besides the states, the patrol moves have to match, an extra one means a re-evaluation
+	/// restarted a patrol that was already under way
+	/// </summary>
+	void Replay(FAutomationTestBase& Test, const TCHAR* Name, TArrayView<const FStep> Script, TArrayView<const EState> Expected)
+	{
+		FScenarioEnemy Polling(false);
+		FScenarioEnemy EventDriven(true);
+		for (int32 Frame = 0; Frame < Script.Num(); ++Frame)
+		{
+			Polling.Frame(Script[Frame]);
+			EventDriven.Frame(Script[Frame]);
+			Test.TestEqual(FString::Printf(TEXT("%s: polling state at frame %d"), Name, Frame), static_cast<int32>(Polling.State), static_cast<int32>(Expected[Frame]));
+			Test.TestEqual(FString::Printf(TEXT("%s: event driven state at frame %d"), Name, Frame), static_cast<int32>(EventDriven.State), static_cast<int32>(Expected[Frame]));
+			Test.TestEqual(FString::Printf(TEXT("%s: patrol moves at frame %d"), Name, Frame), EventDriven.NumPatrolMoves, Polling.NumPatrolMoves);
+		}
+
+		for (const FString& Violation : EventDriven.Violations)
+		{
+			Test.AddError(FString::Printf(TEXT("%s: transition not in the table: %s"), Name, *Violation));
+		}
+	}
+}
+
+/// <summary>
+/// Replays scripted fights through the polling AEnemy::Tick the transition table replaced and through the event driven machine.
+/// Both have to end every frame in the state the old Tick did, and every event driven reaction has to land in a state its row allows.
+/// The scripts cover the patrol and attack timers, entering and leaving the combat and attack radii, AttackEnd, GetHit, Die, and
+/// stuns ending during a patrol and during an attack
+/// </summary>
+bool FEnemyStateMachineScenarioTest::RunTest(const FString& Parameters)
+{
+	using namespace EnemyScenarioTest;
+
+	Replay(*this, TEXT("Fight"), FightScript, FightExpected);
+	Replay(*this, TEXT("Stun"), StunScript, StunExpected);
+	return true;
+}
+
+#endif
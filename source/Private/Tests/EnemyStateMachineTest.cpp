@@ -0,0 +1,81 @@
+#include "Misc/AutomationTest.h"
+#include "Enemy/EnemyStateMachine.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyStateMachineTransitionsTest, "Slash.Enemy.StateMachine.Transitions",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/// <summary>
+/// Walks every (EEnemyState, EEnemyEvent) pair and checks the row AEnemy::HandleEnemyEvent and AEnemy::SetCombatTarget will read for it.
+/// The static_asserts in EnemyStateMachine.h cover the same rules at compile time, this names the offending pair when one breaks
+/// </summary>
+bool FEnemyStateMachineTransitionsTest::RunTest(const FString& Parameters)
+{
+	using namespace EnemyStateMachine;
+
+	for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+	{
+		const EEnemyState State = static_cast<EEnemyState>(StateIndex);
+		for (int32 EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+		{
+			const EEnemyEvent Event = static_cast<EEnemyEvent>(EventIndex);
+			const FTransition& Transition = GetTransition(State, Event);
+			const FString Pair = FString::Printf(TEXT("(state %d, event %d)"), StateIndex, EventIndex);
+
+			TestEqual(Pair + TEXT(" row state"), static_cast<int32>(Transition.State), StateIndex);
+			TestEqual(Pair + TEXT(" row event"), static_cast<int32>(Transition.Event), EventIndex);
+			TestTrue(Pair + TEXT(" allows at least one state"), Transition.AllowedStates != 0);
+
+			if (State == EEnemyState::EES_Dead)
+			{
+				// Dead is terminal, SetCombatTarget relies on the Ignore to leave corpses alone
+				TestEqual(Pair + TEXT(" is ignored"), static_cast<int32>(Transition.Reaction), static_cast<int32>(EEnemyReaction::EER_Ignore));
+				TestEqual(Pair + TEXT(" stays dead"), static_cast<int32>(Transition.AllowedStates), static_cast<int32>(StateBit(EEnemyState::EES_Dead)));
+				continue;
+			}
+
+			if (Event == EEnemyEvent::EEE_Die)
+			{
+				TestEqual(Pair + TEXT(" ends dead"), static_cast<int32>(Transition.AllowedStates), static_cast<int32>(StateBit(EEnemyState::EES_Dead)));
+				continue;
+			}
+
+			TestFalse(Pair + TEXT(" can't kill"), Transition.Allows(EEnemyState::EES_Dead));
+			switch (Transition.Reaction)
+			{
+			case EEnemyReaction::EER_Ignore:
+				TestEqual(Pair + TEXT(" ignoring keeps the state"), static_cast<int32>(Transition.AllowedStates), static_cast<int32>(StateBit(State)));
+				break;
+			case EEnemyReaction::EER_EvaluatePatrol:
+				TestTrue(Pair + TEXT(" patrol evaluation can patrol"), Transition.Allows(EEnemyState::EES_Patrolling));
+				break;
+			case EEnemyReaction::EER_EvaluateCombat:
+				// CheckCombatTarget keeps an engaged enemy engaged, from anywhere else it can at least chase
+				TestTrue(Pair + TEXT(" combat evaluation has an outcome"), Transition.Allows(State == EEnemyState::EES_Engaged ? EEnemyState::EES_Engaged : EEnemyState::EES_Chasing));
+				break;
+			default:
+				AddError(Pair + TEXT(" has an unknown reaction"));
+				break;
+			}
+		}
+
+		// Every living state has to react to a new target, or SetCombatTarget would silently drop it
+		if (State != EEnemyState::EES_Dead)
+		{
+			TestNotEqual(FString::Printf(TEXT("State %d reacts to EEE_TargetAcquired"), StateIndex),
+				static_cast<int32>(GetTransition(State, EEnemyEvent::EEE_TargetAcquired).Reaction), static_cast<int32>(EEnemyReaction::EER_Ignore));
+
+			// It stands in for every event dropped during the stun. A patrol must not evaluate combat, losing interest would restart
+			// the move its still armed patrol timer starts again, targets taken during the stun are acquired separately
+			const bool bPatrol = State == EEnemyState::EES_Idle || State == EEnemyState::EES_Patrolling;
+			TestEqual(FString::Printf(TEXT("State %d reaction to EEE_StunEnded"), StateIndex),
+				static_cast<int32>(GetTransition(State, EEnemyEvent::EEE_StunEnded).Reaction),
+				static_cast<int32>(bPatrol ? EEnemyReaction::EER_EvaluatePatrol : EEnemyReaction::EER_EvaluateCombat));
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "Misc/AutomationTest.h"
+#include "Items/MeleeSweep.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Slash/SlashCollision.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMeleeSweepFrameRateTest, "Slash.Items.MeleeSweep.FrameRateIndependence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MeleeSweepTest
+{
+	const double SwingDuration = 0.3;
+	const double BladeBase = 20.0;
+	const double BladeTip = 120.0;
+	const FVector BladeExtents(5.0, 5.0, 5.0);
+	const float TargetRadius = 15.f;
+
+	// Angle in degrees and distance from the pivot, the last two are outside the swing and must never be hit
+	const FVector2D Targets[] = { { -70.0, 60.0 }, { -30.0, 100.0 }, { 5.0, 40.0 }, { 40.0, 110.0 }, { 75.0, 80.0 }, { 130.0, 80.0 }, { 0.0, 170.0 } };
+	constexpr int32 NumTargets = UE_ARRAY_COUNT(Targets);
+	constexpr int32 NumReachable = NumTargets - 2;
+
+	// Eases in and out like an attack montage, sweeping from -90 to 90 degrees around the pivot
+	FMeleeBladePose PoseAt(double Time)
+	{
+		const double Alpha = FMath::SmoothStep(0.0, 1.0, FMath::Clamp(Time / SwingDuration, 0.0, 1.0));
+		const FQuat Rotation(FVector::UpVector, FMath::DegreesToRadians(-90.0 + 180.0 * Alpha));
+		const FVector Direction = Rotation.GetForwardVector();
+		return { Direction * BladeBase, Direction * BladeTip, Rotation };
+	}
+
+	/// <summary>
+	/// Plays one swing at FrameRate, tracing every sub-step sample against the world the way AWeapon::TraceMeleeSample does
+	/// </summary>
+	TArray<const AActor*> Swing(UWorld* World, float FrameRate, float SubStepRate)
+	{
+		const float DeltaTime = 1.f / FrameRate;
+		const FCollisionQueryParams Params(SCENE_QUERY_STAT(MeleeSweepTest), false);
+		TArray<FHitResult> Hits;
+
+		FMeleeSweep Sweep;
+		Sweep.Begin(PoseAt(0.0), SubStepRate);
+		for (double Time = DeltaTime; Time < SwingDuration + DeltaTime; Time += DeltaTime)
+		{
+			Sweep.Advance(DeltaTime, PoseAt(Time), [&](const FMeleeBladePose& Pose)
+			{
+				World->SweepMultiByChannel(Hits, Pose.Base, Pose.Tip, Pose.Rotation, ECC_Hitbox, FCollisionShape::MakeBox(BladeExtents), Params);
+				for (const FHitResult& Hit : Hits)
+				{
+					Sweep.MarkHit(Hit.GetActor());
+				}
+			});
+		}
+		Sweep.End();
+
+		return TArray<const AActor*>(Sweep.GetHitActors());
+	}
+}
+
+/// <summary>
+/// Swings a blade through a ring of hitbox spheres in a test world at 20, 60 and 144 FPS.
+/// Every frame rate has to hit the same actors, each at most once, and all of those in reach of the blade
+/// </summary>
+bool FMeleeSweepFrameRateTest::RunTest(const FString& Parameters)
+{
+	using namespace MeleeSweepTest;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	TArray<const AActor*> Reachable;
+	for (int32 Index = 0; Index < NumTargets; ++Index)
+	{
+		AActor* Target = World->SpawnActor<AActor>();
+		USphereComponent* Sphere = NewObject<USphereComponent>(Target);
+		Sphere->SetSphereRadius(TargetRadius);
+		Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Sphere->SetCollisionObjectType(ECC_Hitbox);
+		Sphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		Sphere->SetCollisionResponseToChannel(ECC_Hitbox, ECollisionResponse::ECR_Block);
+		Target->SetRootComponent(Sphere);
+		Sphere->RegisterComponent();
+		Target->SetActorLocation(FQuat(FVector::UpVector, FMath::DegreesToRadians(Targets[Index].X)).GetForwardVector() * Targets[Index].Y);
+		if (Index < NumReachable)
+		{
+			Reachable.Add(Target);
+		}
+	}
+	// Lets the physics scene pick up the new bodies before the first query
+	World->Tick(LEVELTICK_All, 1.f / 60.f);
+
+	const float SubStepRate = 120.f;
+	const float FrameRates[] = { 20.f, 60.f, 144.f };
+	for (const float FrameRate : FrameRates)
+	{
+		const TArray<const AActor*> Hit = Swing(World, FrameRate, SubStepRate);
+		TestEqual(FString::Printf(TEXT("Actors hit at %.0f FPS"), FrameRate), Hit.Num(), NumReachable);
+		for (int32 Index = 0; Index < NumReachable; ++Index)
+		{
+			TestTrue(FString::Printf(TEXT("Target %d hit at %.0f FPS"), Index, FrameRate), Hit.Contains(Reachable[Index]));
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -17,6 +17,8 @@ class SLASH_API ABreakableActor : public AActor, public IHitInterface
 public:	
 	ABreakableActor();
 
+	void Shatter();
+
 protected:
 	virtual void BeginPlay() override;
 
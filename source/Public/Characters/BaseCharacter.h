@@ -2,11 +2,15 @@
 
 #include "CoreMinimal.h"
 #include "Interfaces/HitInterface.h"
+#include "Items/MeleeSweep.h"
 #include "GameFramework/Character.h"
 #include "BaseCharacter.generated.h"
 
 class AWeapon;
 class UAttributeComponent;
+class UFactionComponent;
+class UHitboxComponent;
+class UWeaponTrajectoryAsset;
 
 UCLASS()
 class SLASH_API ABaseCharacter : public ACharacter, public IHitInterface
@@ -23,8 +27,20 @@ public:
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 	/** /IHitInterface */
 
+	FORCEINLINE UFactionComponent* GetFaction() const { return Faction; }
+	FORCEINLINE UHitboxComponent* GetHitboxes() const { return Hitboxes; }
+	FORCEINLINE UAnimMontage* GetAttackMontage() const { return AttackMontage; }
+	FORCEINLINE const TArray<FName>& GetAttackMontageSections() const { return AttackMontageSections; }
+
+	bool GetBakedBladePose(const AWeapon* Weapon, FMeleeBladePose& OutPose) const;
+
+	// From UStatusEffectSubsystem
+	FORCEINLINE bool IsStunned() const { return bStunned; }
+	FORCEINLINE float GetSlowMultiplier() const { return SlowMultiplier; }
+
 protected:
 	/** AActor */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
 	/** /AActor */
 
@@ -34,6 +50,7 @@ protected:
 	virtual bool CanDodge();
 	virtual void Attack();
 	virtual bool IsAlive();
+	void ResetCharacterState();
 
 	/** Montages **/
 	virtual void PlayHitReactMontage(const FName& SectionName);
@@ -45,13 +62,20 @@ protected:
 	void PlayMontage(UAnimMontage* Montage);
 	int32 PlayRandomMontageSection(UAnimMontage* Montage, const TArray<FName>& SectionNames);
 
+	friend class UAnimNotifyState_Dodge;
+	friend class UAnimNotify_AttackEnd;
+
+	// Called by UStatusEffectSubsystem when the character's stun or slow changes
+	virtual void SetStatusEffects(bool bInStunned, float InSlowMultiplier);
+	friend class UStatusEffectSubsystem;
+
 	/** Blueprint Native/Callable Functions **/
 	UFUNCTION(BlueprintNativeEvent)
 	void Die();
 	UFUNCTION(BlueprintCallable)
-	virtual void AttackEnd();	// Called by the animation blueprint when the montage notifies the attack is almost over
+	virtual void AttackEnd();	// Called by UAnimNotify_AttackEnd, or the animation blueprint, when the attack is almost over
 	UFUNCTION(BlueprintCallable)
-	virtual void DodgeEnd();	// Called by the animation blueprint when the montage notifies the dodge is almost over
+	virtual void DodgeEnd();	// Called by UAnimNotifyState_Dodge, or the animation blueprint, when the dodge is almost over
 	UFUNCTION(BlueprintCallable)
 	FVector GetTranslationWarpTarget();
 	UFUNCTION(BlueprintCallable)
@@ -77,6 +101,10 @@ protected:
 	UPROPERTY(EditAnywhere, category = "Montages")
 	TArray<FName> AttackMontageSections;
 
+	// Blade paths of AttackMontageSections, traced instead of the animated weapon when set
+	UPROPERTY(EditDefaultsOnly, category = "Montages")
+	UWeaponTrajectoryAsset* AttackTrajectories;
+
 	UPROPERTY(EditAnywhere, category = "Montages")
 	TArray<FName> DeathMontageSections;
 
@@ -89,6 +117,12 @@ protected:
 	UPROPERTY(VisibleAnywhere, category = "Combat")
 	UAttributeComponent* Attributes;
 
+	UPROPERTY(VisibleAnywhere, category = "Combat")
+	UFactionComponent* Faction;
+
+	UPROPERTY(VisibleAnywhere, category = "Combat")
+	UHitboxComponent* Hitboxes;
+
 	UPROPERTY(VisibleInstanceOnly, category = "Combat")
 	AWeapon* EquippedItem;
 
@@ -101,5 +135,13 @@ protected:
 private:
 	void DirectionalHitReact(const FVector& ImpactPoint);
 
+	// Section of the attack montage playing, for the baked trajectories
+	FName AttackSection;
+
 	void DisableCapsule();
+
+	// Slot in UStatusEffectSubsystem, and what its effects add up to
+	int32 StatusEffectIndex = INDEX_NONE;
+	bool bStunned = false;
+	float SlowMultiplier = 1.f;
 };
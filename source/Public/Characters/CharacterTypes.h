@@ -32,5 +32,29 @@ enum class EEnemyState : uint8
 	EES_Patrolling,
 	EES_Chasing,
 	EES_Attacking,
-	EES_Engaged
-};
\ No newline at end of file
+	EES_Engaged,
+	EES_Waiting UMETA(ToolTip = "In attack range without an attack token from UCombatCoordinator"),
+
+	EES_MAX UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class ETeam : uint8
+{
+	ET_None,
+	ET_Player,
+	ET_Enemy,
+
+	ET_MAX UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EStatusEffectType : uint8
+{
+	ESE_Bleed UMETA(DisplayName = "Bleed"),
+	ESE_Poison UMETA(DisplayName = "Poison"),
+	ESE_Stun UMETA(DisplayName = "Stun"),
+	ESE_Slow UMETA(DisplayName = "Slow"),
+
+	ESE_MAX UMETA(Hidden)
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "CombatAnimNotifies.generated.h"
+
+/**
+ * Native notifies for combat timing, placed on the montages in place of named notifies that the animation blueprints forward
+ * to the BlueprintCallable character functions. They call the owning character directly, so no Blueprint VM runs per swing.
+ * Windows are notify states, their end also runs when the montage is interrupted. One-off events are plain notifies.
+ */
+
+/** Weapon collision for the length of the state, replaces the SetWeaponCollisionEnable calls */
+UCLASS(meta = (DisplayName = "Weapon Collision Window"))
+class SLASH_API UAnimNotifyState_WeaponCollision : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override;
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+};
+
+/** The dodge is over when the state ends, replaces the DodgeEnd call */
+UCLASS(meta = (DisplayName = "Dodge Window"))
+class SLASH_API UAnimNotifyState_Dodge : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+};
+
+/** Replaces the AttackEnd call */
+UCLASS(meta = (DisplayName = "Attack End"))
+class SLASH_API UAnimNotify_AttackEnd : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+};
+
+/** Replaces the HitReactEnd call */
+UCLASS(meta = (DisplayName = "Hit React End"))
+class SLASH_API UAnimNotify_HitReactEnd : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+};
+
+/** Moves the weapon between the hand and the back, replaces the EquipEnd call */
+UCLASS(meta = (DisplayName = "Equip Attach"))
+class SLASH_API UAnimNotify_EquipAttach : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+
+	// True for the Equip section (back to hand), false for Unequip
+	UPROPERTY(EditAnywhere, Category = "Equip")
+	bool bEquip = true;
+};
@@ -23,7 +23,6 @@ public:
 	ASlashCharacter();
 	/** AActor */
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
-	virtual void Tick(float DeltaTime) override;
 	/** /AActor */
 
 	/** IHitInterface */
@@ -38,12 +37,16 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual bool CanAttack() override;
 	virtual void AttackEnd() override;
 	virtual void DodgeEnd() override;
 	virtual void Die_Implementation() override;
 	virtual bool CanDodge() override;
-	virtual void HandleDamage(float Damage) override;
+	virtual void SetStatusEffects(bool bInStunned, float InSlowMultiplier) override;
+
+	friend class UAnimNotify_HitReactEnd;
+	friend class UAnimNotify_EquipAttach;
 
 	UFUNCTION(BlueprintCallable)
 	void EquipEnd(const bool bEquipped);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "AreaAttackSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class EAreaAttackShape : uint8
+{
+	EAAS_Sphere,
+	EAAS_Cone UMETA(ToolTip = "Sphere of Radius limited to ConeHalfAngle around Direction"),
+	EAAS_Capsule UMETA(ToolTip = "Capsule of Radius and HalfHeight along Direction")
+};
+
+USTRUCT(BlueprintType)
+struct FAreaAttack
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EAreaAttackShape Shape = EAreaAttackShape::EAAS_Sphere;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector Origin = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector Direction = FVector::ForwardVector;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius = 300.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float HalfHeight = 300.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ConeHalfAngle = 45.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Damage = 20.f;
+	// Share of Damage left at the edge of the area, falling off linearly from the center or the capsule's axis
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", ClampMax = "1"))
+	float EdgeDamageScale = 0.5f;
+	// Targets behind world geometry are spared. Their hits land on the next frame once the traces are back
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bRequireLineOfSight = false;
+	// Nearest targets first, zero uses the subsystem's MaxTargetsPerAttack
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxTargets = 0;
+};
+
+/**
+ * Ground slams, explosions and cleaves. Each attack is one overlap query on the Hitbox channel, which returns character
+ * hitboxes and breakables only, then the targets are filtered by shape and faction, sorted nearest first and capped.
+ * Damage falls off with distance and goes through the damage queue like AWeapon's, or GetHit and ApplyDamage without it.
+ * Line of sight checks for all of an attack's targets are issued together as async traces and resolved on the next tick.
+ * Breakables are shattered as well as hit. Settings come from [/Script/Slash.AreaAttackSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UAreaAttackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	// Returns how many targets were hit, or will be once line of sight is checked
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	int32 ApplyAreaAttack(AActor* Attacker, const FAreaAttack& Attack);
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	struct FAreaTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FVector Point = FVector::ZeroVector;
+		double DistanceSq = 0.0;
+		float DamageScale = 1.f;
+		FTraceHandle LineOfSight;
+	};
+
+	struct FPendingAreaAttack
+	{
+		TWeakObjectPtr<AActor> Attacker;
+		FAreaAttack Attack;
+		TArray<FAreaTarget> Targets;
+		uint64 Frame = 0;
+	};
+
+	using FTargetArray = TArray<FAreaTarget, TInlineAllocator<32>>;
+
+	void GatherTargets(AActor* Attacker, const FAreaAttack& Attack, FTargetArray& OutTargets);
+	void ApplyToTarget(AActor* Attacker, const FAreaAttack& Attack, const FAreaTarget& Target);
+
+	UPROPERTY(Config)
+	int32 MaxTargetsPerAttack = 24;
+
+	TArray<FOverlapResult> Overlaps;
+	TArray<FPendingAreaAttack> PendingAttacks;
+	TArray<FPendingAreaAttack> ResolvingAttacks;
+	FTraceDatum TraceData;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class UWeaponTraceSubsystem;
+
+/**
+ * Collects the hits landed during a frame and resolves them together in this subsystem's tick, in the order they were queued.
+ * Every hit on the same victim is summed into one ApplyDamage, so health, death, the health bar and the HUD change once per
+ * victim per frame. GetHit runs after the damage, so hit reactions already know whether the victim survived.
+ */
+UCLASS()
+class SLASH_API UDamageQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void QueueHit(AActor* Victim, float Damage, const FVector& ImpactPoint, AActor* Hitter, AController* EventInstigator, AActor* DamageCauser);
+
+	FORCEINLINE int32 GetNumPending() const { return PendingHits.Num(); }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	UPROPERTY()
+	UWeaponTraceSubsystem* WeaponTraces;
+
+	struct FQueuedHit
+	{
+		TWeakObjectPtr<AActor> Victim;
+		TWeakObjectPtr<AActor> Hitter;
+		TWeakObjectPtr<AController> EventInstigator;
+		TWeakObjectPtr<AActor> DamageCauser;
+		FVector ImpactPoint = FVector::ZeroVector;
+		float Damage = 0.f;
+	};
+
+	struct FVictimDamage
+	{
+		int32 FirstHit = INDEX_NONE;
+		float TotalDamage = 0.f;
+	};
+
+	TArray<FQueuedHit> PendingHits;
+	TArray<FQueuedHit> ResolvingHits;
+
+	// Victims in the order of their first hit this frame
+	TArray<FVictimDamage> Victims;
+	TMap<AActor*, int32> VictimIndices;
+};
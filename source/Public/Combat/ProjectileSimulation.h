@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Ballistic projectiles stored as structure of arrays, one float array per component, so Integrate can move four
+ * projectiles per SIMD instruction. Velocity loses Drag of itself per second and gains GravityZ * GravityScale.
+ * Each projectile also keeps where it was last swept from, so UProjectileSubsystem can sweep on a budget without leaving a gap.
+ */
+class SLASH_API FProjectileSimulation
+{
+public:
+	int32 Add(const FVector& Location, const FVector& Velocity, float Drag, float GravityScale, float Lifetime);
+	void RemoveAtSwap(int32 Index);
+	void Reset();
+	void Reserve(int32 Number);
+
+	void Integrate(float DeltaTime, float GravityZ);
+
+	FORCEINLINE int32 Num() const { return PositionX.Num(); }
+	FORCEINLINE FVector GetLocation(int32 Index) const { return FVector(PositionX[Index], PositionY[Index], PositionZ[Index]); }
+	FORCEINLINE FVector GetVelocity(int32 Index) const { return FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]); }
+	FORCEINLINE FVector GetSweptLocation(int32 Index) const { return FVector(SweptX[Index], SweptY[Index], SweptZ[Index]); }
+	void MarkSwept(int32 Index);
+
+	// Components
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+	TArray<float> SweptX;
+	TArray<float> SweptY;
+	TArray<float> SweptZ;
+	TArray<float> Drags;
+	TArray<float> GravityScales;
+	TArray<float> TimesLeft;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Combat/ProjectileSimulation.h"
+#include "Slash/SlashBenchmark.h"
+#include "ProjectileSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Arrows, thrown weapons and other ranged attacks without an actor each. FProjectileSimulation moves them all in SIMD batches,
+ * then each projectile is swept from where it was last swept to where it is now with the async trace API, at most MaxSweepsPerFrame
+ * a frame round robin. Results are read on the next tick: hits on hitboxes, the world and breakables stop the projectile and
+ * hostile victims are damaged through the damage queue, with the same friend-or-foe rules as AWeapon.
+ * Projectiles are drawn as instances of InstanceMesh facing along their velocity. Settings come from [/Script/Slash.ProjectileSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void Fire(AActor* Shooter, const FVector& Location, const FVector& Velocity, float Damage, float Drag = 0.f, float GravityScale = 1.f);
+	void ClearProjectiles();
+	void StartBenchmark(int32 NumFrames, int32 SweepBudget);
+
+	FORCEINLINE int32 GetNumProjectiles() const { return Simulation.Num(); }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void ResolveSweeps();
+	void ApplyHit(int32 Index, const FHitResult& Hit);
+	void RemoveExpired();
+	void IssueSweeps();
+	void RemoveProjectile(int32 Index);
+	void UpdateInstances();
+	void FinishBenchmarkFrame();
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UStaticMesh> InstanceMesh;
+
+	UPROPERTY(Config)
+	float SweepRadius = 4.f;
+
+	UPROPERTY(Config)
+	float Lifetime = 10.f;
+
+	UPROPERTY(Config)
+	int32 MaxSweepsPerFrame = 5000;
+
+	UPROPERTY()
+	AActor* InstanceHost;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances;
+
+	FProjectileSimulation Simulation;
+
+	// Parallel to the simulation's components
+	TArray<TWeakObjectPtr<AActor>> Shooters;
+	TArray<float> Damages;
+
+	struct FPendingSweep
+	{
+		int32 Index = INDEX_NONE;
+		FTraceHandle Handle;
+	};
+
+	// Issued in ascending index order last tick. Nothing is removed until they are resolved, so the indices still hold
+	TArray<FPendingSweep> PendingSweeps;
+	FTraceDatum TraceData;
+	FCollisionObjectQueryParams ObjectParams;
+	int32 SweepCursor = 0;
+
+	// Instances that already exist and are moved, and the ones added this frame after them
+	TArray<FTransform> InstanceTransforms;
+	TArray<FTransform> AddedInstanceTransforms;
+	TArray<int32> RemovedInstances;
+
+	// Per stage timings of the frames left in a slash.Projectile.WorldBenchmark run
+	struct FStageBenchmark
+	{
+		FSlashBenchmarkTimer Resolve;
+		FSlashBenchmarkTimer Integrate;
+		FSlashBenchmarkTimer Sweeps;
+		FSlashBenchmarkTimer Instances;
+		int64 NumSweeps = 0;
+		int64 NumProjectiles = 0;
+		int32 NumBudgetLimited = 0;
+		int32 FramesLeft = 0;
+		int32 SavedMaxSweepsPerFrame = 0;
+	};
+	FStageBenchmark Benchmark;
+};
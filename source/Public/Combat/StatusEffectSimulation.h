@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+/**
+ * Active status effects stored as structure of arrays, advanced together once per frame.
+ * Effects point at target slots, which hold what the effects add up to: damage due this frame, the number of stuns and
+ * the strongest slow. Bleed and poison deal Magnitude every Period seconds including one landing on expiry. Slow's
+ * Magnitude is the speed multiplier. UStatusEffectSubsystem owns one per world and maps its target slots to characters.
+ */
+class SLASH_API FStatusEffectSimulation
+{
+public:
+	int32 AllocateTarget();
+	// Removes every effect on the target too
+	void FreeTarget(int32 Target);
+
+	void Add(int32 Target, EStatusEffectType Type, float Magnitude, float Duration, float Period);
+	void Advance(float DeltaTime);
+	void Reset();
+	void Reserve(int32 NumEffects);
+
+	float ConsumeDamage(int32 Target);
+
+	FORCEINLINE int32 Num() const { return TimesLeft.Num(); }
+	FORCEINLINE bool IsStunned(int32 Target) const { return TargetStuns[Target] > 0; }
+	FORCEINLINE float GetSlowMultiplier(int32 Target) const { return TargetSlows[Target]; }
+
+	// Filled by Advance
+	TArray<int32> DamagedTargets;
+	TArray<int32> ChangedTargets;
+	TArray<int32> EmptiedTargets;
+
+	// Effects
+	TArray<int32> Targets;
+	TArray<EStatusEffectType> Types;
+	TArray<float> Magnitudes;
+	TArray<float> Periods;
+	TArray<float> NextTicks;
+	TArray<float> TimesLeft;
+
+	// Targets, by slot
+	TArray<float> TargetDamage;
+	TArray<int32> TargetStuns;
+	TArray<float> TargetSlows;
+	TArray<int32> TargetEffectCounts;
+	TArray<bool> TargetChanged;
+	TArray<int32> FreeTargets;
+
+private:
+	void RemoveAtSwap(int32 Index);
+	void MarkChanged(int32 Target);
+};
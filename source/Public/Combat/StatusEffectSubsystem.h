@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Combat/StatusEffectSimulation.h"
+#include "StatusEffectSubsystem.generated.h"
+
+class ABaseCharacter;
+
+/**
+ * Bleeds, poisons, stuns and slows on every character, in one FStatusEffectSimulation instead of timers per actor.
+ * Each tick advances all effects, then applies each target's damage for the frame as one ApplyDamage, so it goes through
+ * ABaseCharacter::HandleDamage like any hit. Stun and slow changes are pushed to the character, which answers IsStunned
+ * and GetSlowMultiplier from its own fields. A character's effects end when it dies or leaves play.
+ * Settings come from [/Script/Slash.StatusEffectSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UStatusEffectSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	// Magnitude is damage per Period for bleed and poison, and the speed multiplier for slow
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	void ApplyEffect(ABaseCharacter* Target, EStatusEffectType Type, float Magnitude, float Duration, float Period = 1.f);
+
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	void ClearEffects(ABaseCharacter* Target);
+
+	FORCEINLINE int32 GetNumEffects() const { return Simulation.Num(); }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	UPROPERTY(Config)
+	float MinPeriod = 0.1f;
+
+	UPROPERTY(Config)
+	float MinSlowMultiplier = 0.1f;
+
+	FStatusEffectSimulation Simulation;
+
+	// By target slot, an occupied slot is the character's StatusEffectIndex
+	TArray<ABaseCharacter*> TargetCharacters;
+
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<ABaseCharacter> Target;
+		float Damage = 0.f;
+	};
+	TArray<FPendingDamage> PendingDamage;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "WeaponTraceSubsystem.generated.h"
+
+class AWeapon;
+
+/**
+ * Runs the traces of every swinging AWeapon through the async trace API instead of blocking the game thread on each one.
+ * Traces requested during a frame run on the physics threads while the frame finishes and are resolved on the next frame,
+ * in this subsystem's tick or UDamageQueueSubsystem's, whichever comes first. They are sorted by weapon and request order so
+ * hits and damage are applied in the same order every run.
+ */
+UCLASS()
+class SLASH_API UWeaponTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void RequestSweep(AWeapon* Weapon, uint32 SwingId, EAsyncTraceType TraceType, const FVector& Start, const FVector& End, const FQuat& Rotation,
+		const FCollisionShape& Shape, const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams);
+	void ResolveReadyTraces();
+
+	FORCEINLINE int32 GetNumPending() const { return Requests.Num(); }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	struct FWeaponTraceRequest
+	{
+		TWeakObjectPtr<AWeapon> Weapon;
+		uint32 WeaponId = 0;
+		uint32 SwingId = 0;
+		uint32 Sequence = 0;
+		uint64 Frame = 0;
+		double SubmitTime = 0.0;
+		FTraceHandle Handle;
+	};
+
+	// In submission order, so the ones from earlier frames are always at the front
+	TArray<FWeaponTraceRequest> Requests;
+	TArray<FWeaponTraceRequest> ResolvingRequests;
+	FTraceDatum TraceData;
+	uint32 NextSequence = 0;
+	int32 NumRequestedThisFrame = 0;
+	uint64 LastResolvedFrame = 0;
+};
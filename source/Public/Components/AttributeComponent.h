@@ -4,9 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Components/AttributeModifier.h"
 #include "AttributeComponent.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAttributePercentChanged, float /* Percent */);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAttributeValueChanged, int32 /* Value */);
 
+/**
+ * Health, stamina and currencies of a character. Doesn't tick: stamina is kept as its value at StaminaTimestamp and
+ * regenerates analytically when read.
+ * MaxHealth, MaxStamina, StaminaRechargeRate and DodgeStaminaCost are base values. Their modified values are cached and
+ * only aggregated again when a modifier on them is added, removed or expires; one timer expires modifiers in end time order.
+ */
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class SLASH_API UAttributeComponent : public UActorComponent
 {
@@ -14,9 +23,9 @@ class SLASH_API UAttributeComponent : public UActorComponent
 
 public:	
 	UAttributeComponent();
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 protected:
+	virtual void OnRegister() override;
 	virtual void BeginPlay() override;
 
 private:
@@ -38,18 +47,81 @@ private:
 	int32 DodgeStaminaCost = 10.f;
 
 public:
+	void ResetAttributes();
+	void SetHealthPercent(float Percent);
 	void ChangeHealth(float Amount);
 	void ChangeGold(int32 Amount);
 	void ChangeSouls(int32 Amount);
 	void UseStamina(float Amount);
 	float GetHealthPercent();
-	float GetStaminaPercent();
+	float GetStaminaPercent() const;
 	bool IsAlive();
+	float GetStamina() const;
+	bool CanUseDodge() const;
+	FORCEINLINE bool IsStaminaRegenerating() const { return GetStaminaRechargeRate() > 0.f && GetStamina() < GetMaxStamina(); }
+
+	// Stamina Elapsed seconds after it was Stamina, clamped to [0, Max] like per frame regeneration
+	static float EvaluateStaminaRegen(float Stamina, float Max, float RechargeRate, double Elapsed);
 
 	FORCEINLINE int32 GetGold() const { return Gold; }
 	FORCEINLINE int32 GetSouls() const { return Souls; }
-	FORCEINLINE float GetStamina() const { return CurrentStamina; }
-	FORCEINLINE float GetStaminaRechargeRate() const { return StaminaRechargeRate; }
-	FORCEINLINE float GetDodgeCost() const { return DodgeStaminaCost; }
-	FORCEINLINE bool CanUseDodge() const { return CurrentStamina >= DodgeStaminaCost; }
+	FORCEINLINE float GetAttribute(EModifiedAttribute Attribute) const { return Aggregated[static_cast<int32>(Attribute)]; }
+	FORCEINLINE float GetMaxHealth() const { return GetAttribute(EModifiedAttribute::EMA_MaxHealth); }
+	FORCEINLINE float GetMaxStamina() const { return GetAttribute(EModifiedAttribute::EMA_MaxStamina); }
+	FORCEINLINE float GetStaminaRechargeRate() const { return GetAttribute(EModifiedAttribute::EMA_StaminaRechargeRate); }
+	FORCEINLINE float GetDodgeCost() const { return GetAttribute(EModifiedAttribute::EMA_DodgeStaminaCost); }
+
+	// Returns the id to remove it with
+	int32 AddModifier(const FAttributeModifier& Modifier);
+	bool RemoveModifier(int32 ModifierId);
+	void ClearModifiers();
+
+	// Broadcast only when the value actually changed
+	FOnAttributePercentChanged OnHealthChanged;
+	// Not while regenerating, read GetStaminaPercent for that. Once full, ScheduleStaminaFull's timer broadcasts it if anything is bound
+	FOnAttributePercentChanged OnStaminaChanged;
+	FOnAttributeValueChanged OnGoldChanged;
+	FOnAttributeValueChanged OnSoulsChanged;
+
+private:
+	void SetHealth(float NewHealth);
+	void SetStamina(float NewStamina);
+	void ScheduleStaminaFull();
+	void OnStaminaFull();
+	double GetTimeSeconds() const;
+
+	// CurrentStamina is the stamina at this world time
+	double StaminaTimestamp = 0.0;
+	FTimerHandle StaminaFullTimer;
+
+	// Modifiers
+	struct FActiveModifier
+	{
+		FAttributeModifier Modifier;
+		int32 Id = 0;
+	};
+
+	struct FModifierExpiry
+	{
+		double EndTime = 0.0;
+		int32 Id = 0;
+	};
+
+	float GetBaseValue(EModifiedAttribute Attribute) const;
+	float Aggregate(EModifiedAttribute Attribute) const;
+	void MarkDirty(EModifiedAttribute Attribute);
+	void ApplyDirtyAttributes();
+	void RemoveModifierAt(int32 Index);
+	void ExpireModifiers();
+	void ScheduleExpiry();
+
+	// Sorted by priority, then by when they were added
+	TArray<FActiveModifier> Modifiers;
+	// Sorted by end time, only modifiers with a duration
+	TArray<FModifierExpiry> Expiries;
+	FTimerHandle ExpiryTimer;
+	int32 NextModifierId = 1;
+
+	float Aggregated[static_cast<int32>(EModifiedAttribute::EMA_MAX)] = {};
+	uint32 DirtyAttributes = 0;
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeModifier.generated.h"
+
+UENUM(BlueprintType)
+enum class EModifiedAttribute : uint8
+{
+	EMA_MaxHealth UMETA(DisplayName = "Max Health"),
+	EMA_MaxStamina UMETA(DisplayName = "Max Stamina"),
+	EMA_StaminaRechargeRate UMETA(DisplayName = "Stamina Recharge Rate"),
+	EMA_DodgeStaminaCost UMETA(DisplayName = "Dodge Stamina Cost"),
+
+	EMA_MAX UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EModifierOp : uint8
+{
+	EMO_Add UMETA(DisplayName = "Add"),
+	EMO_Multiply UMETA(DisplayName = "Multiply"),
+	EMO_Override UMETA(DisplayName = "Override")
+};
+
+/**
+ * A buff or debuff on one of UAttributeComponent's attributes, from gear or a status effect.
+ * Modifiers apply to the base value in ascending Priority, in the order they were added within a priority,
+ * so an override only replaces what came before it.
+ */
+USTRUCT(BlueprintType)
+struct FAttributeModifier
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Modifier)
+	EModifiedAttribute Attribute = EModifiedAttribute::EMA_MaxHealth;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Modifier)
+	EModifierOp Op = EModifierOp::EMO_Add;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Modifier)
+	float Magnitude = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Modifier)
+	int32 Priority = 0;
+
+	// Seconds until it expires, zero or less lasts until removed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Modifier)
+	float Duration = 0.f;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Characters/CharacterTypes.h"
+#include "FactionComponent.generated.h"
+
+enum class EFactionFlags : uint8
+{
+	None = 0,
+	Targetable = 1 << 0,
+	Dead = 1 << 1
+};
+ENUM_CLASS_FLAGS(EFactionFlags);
+
+/**
+ * Team and combat status of an actor, stored as bitmasks so the friendly fire and targeting checks on the hit and perception
+ * paths are a couple of bit tests instead of scans of the Tags array.
+ * The owner's "Enemy", "EngageableTarget" and "Dead" tags are still written alongside for Blueprints, native code reads this.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class SLASH_API UFactionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFactionComponent();
+
+	void SetTeam(ETeam NewTeam);
+	void SetTargetable(bool bTargetable);
+	void SetDead(bool bDead);
+
+	FORCEINLINE ETeam GetTeam() const { return Team; }
+	FORCEINLINE bool IsDead() const { return EnumHasAnyFlags(Flags, EFactionFlags::Dead); }
+	FORCEINLINE bool IsTargetable() const { return (Flags & (EFactionFlags::Targetable | EFactionFlags::Dead)) == EFactionFlags::Targetable; }
+	FORCEINLINE bool IsHostileTo(const UFactionComponent* Other) const { return Other && (GetHostileMask() & TeamBit(Other->Team)) != 0; }
+
+	static UFactionComponent* FindFaction(const AActor* Actor);
+	static bool IsActorDead(const AActor* Actor);
+	static bool CanDamage(const AActor* Attacker, const AActor* Victim);
+
+private:
+	static constexpr uint8 TeamBit(ETeam InTeam) { return InTeam == ETeam::ET_None ? 0 : static_cast<uint8>(1 << static_cast<uint8>(InTeam)); }
+	static constexpr uint8 AllTeams = static_cast<uint8>((1 << static_cast<uint8>(ETeam::ET_MAX)) - 1) & ~TeamBit(ETeam::ET_None);
+	static_assert(static_cast<uint8>(ETeam::ET_MAX) <= 8, "Team masks are stored in a uint8");
+
+	FORCEINLINE uint8 GetHostileMask() const { return HostileTeams != 0 ? HostileTeams : static_cast<uint8>(AllTeams & ~TeamBit(Team)); }
+
+	void MirrorTag(FName Tag, bool bHasTag);
+
+	UPROPERTY(EditAnywhere, Category = "Faction")
+	ETeam Team = ETeam::ET_None;
+
+	// Teams this one may damage and target, every other team unless set
+	UPROPERTY(EditAnywhere, Category = "Faction", meta = (Bitmask, BitmaskEnum = "/Script/Slash.ETeam"))
+	uint8 HostileTeams = 0;
+
+	EFactionFlags Flags = EFactionFlags::None;
+};
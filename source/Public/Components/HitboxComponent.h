@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HitboxComponent.generated.h"
+
+class UShapeComponent;
+class USkeletalMeshComponent;
+
+UENUM(BlueprintType)
+enum class EHitZone : uint8
+{
+	EHZ_Body,
+	EHZ_Head,
+	EHZ_Limb,
+
+	EHZ_MAX UMETA(Hidden)
+};
+
+USTRUCT()
+struct FHitboxShape
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Bone;
+	UPROPERTY(EditAnywhere)
+	FVector Offset = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere)
+	FRotator Rotation = FRotator::ZeroRotator;
+	// A capsule when BoxExtent is zero
+	UPROPERTY(EditAnywhere)
+	FVector BoxExtent = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere)
+	float Radius = 10.f;
+	UPROPERTY(EditAnywhere)
+	float HalfHeight = 20.f;
+};
+
+/**
+ * A handful of query-only capsules and boxes attached to the owner's bones, on the Hitbox channel that only weapon sweeps trace.
+ * Replaces overlap events on the skeletal mesh: the shapes never generate overlaps, so moving characters don't pay for
+ * UpdateOverlaps against their per-body collision, slash.Hitbox.OverlapCost measures the difference.
+ * Shapes come from Shapes or, when that's empty, from the bodies of the mesh's physics asset. Damage is scaled per zone,
+ * looked up through a bone-to-zone table built on register from BoneZones, where bones inherit the zone of their nearest mapped parent.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class SLASH_API UHitboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHitboxComponent();
+
+	void SetHitboxesEnabled(bool bEnabled);
+
+	EHitZone GetZone(const FHitResult& Hit) const;
+	FORCEINLINE float GetZoneMultiplier(EHitZone Zone) const { return ZoneMultipliers[static_cast<uint8>(Zone)]; }
+	FORCEINLINE int32 GetNumHitboxes() const { return Hitboxes.Num(); }
+
+	static float GetDamageMultiplier(const FHitResult& Hit);
+
+protected:
+	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	USkeletalMeshComponent* FindOwnerMesh() const;
+	void BuildBoneZones(USkeletalMeshComponent* Mesh);
+	void BuildZoneMultipliers();
+	void CreateHitboxes(USkeletalMeshComponent* Mesh);
+	void AddHitbox(USkeletalMeshComponent* Mesh, const FHitboxShape& Shape);
+
+	UPROPERTY(EditAnywhere, Category = "Hitboxes")
+	TArray<FHitboxShape> Shapes;
+
+	UPROPERTY(EditAnywhere, Category = "Hitboxes")
+	TMap<FName, EHitZone> BoneZones;
+
+	// Zones not listed do normal damage
+	UPROPERTY(EditAnywhere, Category = "Hitboxes")
+	TMap<EHitZone, float> ZoneDamageMultipliers;
+
+	UPROPERTY(Transient)
+	TArray<UShapeComponent*> Hitboxes;
+
+	// Parallel to Hitboxes
+	TArray<int32> HitboxBones;
+
+	// Indexed by the mesh's reference skeleton bone index
+	TArray<EHitZone> BoneToZone;
+	float ZoneMultipliers[static_cast<uint8>(EHitZone::EHZ_MAX)];
+
+	TWeakObjectPtr<USkeletalMeshComponent> ZoneMesh;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCoordinator.generated.h"
+
+class AEnemy;
+
+/** Who is attacking, waiting and standing where around one target */
+USTRUCT()
+struct FCombatTargetSlots
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEnemy*> TokenHolders;
+
+	// Waiting enemies in the order they asked, the front one is woken when a token is released
+	UPROPERTY()
+	TArray<AEnemy*> Waiters;
+
+	// One entry per engagement slot around the target, null when free
+	UPROPERTY()
+	TArray<AEnemy*> SlotHolders;
+};
+
+/**
+ * Caps how many enemies attack the same target at once. An enemy in attack range needs one of the target's attack tokens
+ * to start its attack timer, otherwise it waits at an engagement slot around the target in EEnemyState::EES_Waiting.
+ * Waiting enemies make no decisions until a token is released (AttackEnd, Die, LoseInterest, chasing again),
+ * then only the longest waiting one is sent EEnemyEvent::EEE_AttackTokenReleased.
+ * Settings come from the [/Script/Slash.CombatCoordinator] section of the game config.
+ */
+UCLASS(Config = Game)
+class SLASH_API UCombatCoordinator : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	bool RequestAttackToken(AEnemy* Enemy, AActor* Target);
+	void ReleaseAttackToken(AEnemy* Enemy);
+	bool ClaimEngagementSlot(AEnemy* Enemy, AActor* Target, double Radius, FVector& OutLocation);
+	void ReleaseEnemy(AEnemy* Enemy);
+
+	int32 GetNumTokenHolders(AActor* Target) const;
+	int32 GetNumWaiters(AActor* Target) const;
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	FCombatTargetSlots* FindSlots(AEnemy* Enemy);
+	FCombatTargetSlots& AssignTarget(AEnemy* Enemy, AActor* Target);
+	void WakeNextWaiter(AActor* Target);
+	void RemoveIfUnused(AActor* Target);
+
+	UPROPERTY(Config)
+	int32 MaxAttackTokens = 2;
+
+	UPROPERTY(Config)
+	int32 NumEngagementSlots = 8;
+
+	UPROPERTY()
+	TMap<AActor*, FCombatTargetSlots> Targets;
+
+	// The target each enemy holds a token, slot or place in line for
+	UPROPERTY()
+	TMap<AEnemy*, AActor*> EnemyTargets;
+};
@@ -5,16 +5,18 @@
 #include "CoreMinimal.h"
 #include "Characters/BaseCharacter.h"
 #include "Characters/CharacterTypes.h"
+#include "Interfaces/PoolableInterface.h"
 #include "Enemy.generated.h"
 
 class UParticleSystem;
 class UAttributeComponent;
-class UHealthBarComponent;
-class UPawnSensingComponent;
 class AItem;
+struct FEnemySignificanceTier;
+enum class EEnemyEvent : uint8;
+enum class EEnemyRangeFlags : uint8;
 
 UCLASS()
-class SLASH_API AEnemy : public ABaseCharacter
+class SLASH_API AEnemy : public ABaseCharacter, public IPoolableInterface
 {
 	GENERATED_BODY()
 
@@ -24,16 +26,21 @@ public:
 	/** <AActor> */
 	virtual void Tick(float DeltaTime) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
-	virtual void Destroyed() override;
 	/** </AActor> */
 
 	/** IHitInterface */
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 	/** /IHitInterface */
 
+	/** IPoolableInterface */
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+	/** /IPoolableInterface */
+
 protected:
 	/** <AActor> */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** </AActor> */
 
 	/** <ABaseCharacter> */
@@ -42,6 +49,7 @@ protected:
 	virtual bool CanAttack() override;
 	virtual void Attack() override;
 	virtual void AttackEnd() override;
+	virtual void SetStatusEffects(bool bInStunned, float InSlowMultiplier) override;
 	/** </ABaseCharacter> */
 
 
@@ -49,6 +57,12 @@ protected:
 	EEnemyState EnemyState = EEnemyState::EES_Idle;
 
 private:
+	friend class UCombatCoordinator;
+	friend class UEnemyAIManager;
+	friend class UEnemyPerceptionSubsystem;
+	friend class UEnemySignificanceSubsystem;
+	friend class UHealthBarSubsystem;
+	friend class UHordeSubsystem;
 
 	/** <Navigation> */
 	UPROPERTY(EditInstanceOnly, Category = "AI Navigation")
@@ -57,9 +71,16 @@ private:
 	UPROPERTY(EditInstanceOnly, Category = "AI Navigation")
 	AActor* PatrolTarget;
 
+	// Marker the current patrol leg started from, null when the leg didn't start at a marker
+	UPROPERTY()
+	AActor* PatrolOrigin;
+
 	UPROPERTY(EditAnywhere)
 	float WaypointReachedDelay = 1.f;
 
+	UPROPERTY(EditAnywhere, Category = "AI Navigation")
+	double PatrolRadius = 200;
+
 	UPROPERTY(EditAnywhere, Category = Combat)
 	float PatrolWalkSpeed = 125.f;
 
@@ -79,7 +100,16 @@ private:
 	double AttackRadius = 50;
 
 	UFUNCTION()
-	void OnPawnSeen(APawn* Pawn); // Callback for OnPawnSeen in UPawnSensingComponent
+	void OnPawnSeen(APawn* Pawn); // Callback from UEnemyPerceptionSubsystem when a pawn is in sight
+
+	UPROPERTY(EditAnywhere, Category = "AI Perception")
+	float SightRadius = 4000.f;
+
+	UPROPERTY(EditAnywhere, Category = "AI Perception")
+	float PeripheralVisionAngle = 45.f;
+
+	UPROPERTY(EditAnywhere, Category = "AI Perception")
+	float SensingInterval = 0.5f;
 
 
 	UPROPERTY(EditAnywhere, Category = "Combat")
@@ -93,15 +123,51 @@ private:
 	void StartPatrolling();
 	void StartChasing();
 	void CheckPatrolTarget();
+	void CheckPatrolTarget(bool bInPatrolRange);
 	void GetPatrolTarget();
 	void CheckCombatTarget();
+	void CheckCombatTarget(bool bOutsideCombatRadius, bool bOutsideAttackRadius);
 	bool IsOutsideCombatRadius();
 	bool IsOutsideAttackRadius();
+	bool CanAttackFromRange(bool bOutsideAttackRadius) const;
 	void SetCombatTarget(APawn* Target);
 	float NextDecisionTimer = 0.f;
+
+	// Event driven decisions, see EnemyStateMachine.h
+	void HandleEnemyEvent(EEnemyEvent Event);
+	void HandleEnemyEvent(EEnemyEvent Event, EEnemyRangeFlags RangeFlags);
+	void FinishEnemyEvent(EEnemyState FromState, EEnemyEvent Event);
 	void StartAttackTimer();
 	void ClearAttackTimer();
 
+	// Attack tokens and engagement slots from UCombatCoordinator
+	void TryStartAttack();
+	void StartWaiting();
+	void ReleaseCombatSlot();
+
+	// Starts patrolling and hands the enemy to the world subsystems, from BeginPlay or when reused from the pool
+	void StartBehavior();
+	void StopBehavior();
+
+	// Slot in UEnemyAIManager, INDEX_NONE when this enemy ticks itself
+	int32 AIManagerIndex = INDEX_NONE;
+
+	// Handle in USpatialHashSubsystem's grid
+	int32 SpatialHandle = INDEX_NONE;
+	void RegisterWithSpatialHash();
+	void UnregisterFromSpatialHash();
+
+	// Slot in UEnemyPerceptionSubsystem
+	int32 PerceptionIndex = INDEX_NONE;
+	void RegisterWithAISubsystems();
+	void UnregisterFromAISubsystems();
+
+	// Slot in UEnemySignificanceSubsystem
+	int32 SignificanceIndex = INDEX_NONE;
+	void ApplySignificanceTier(const FEnemySignificanceTier& Tier);
+	void SetSignificanceAsleep(bool bAsleep);
+	void SetHealthBarEnabled(bool bEnabled);
+
 
 	// Navigation
 	void MoveToTarget(AActor* Target);
@@ -117,19 +183,17 @@ private:
 	float DeathLifeSpan = 3.f;
 	UPROPERTY(EditAnywhere, Category = Combat)
 	float MoveToAcceptanceRadius = 15.f;
+	// Gap left between this enemy's capsule and the target's while waiting for an attack token
+	UPROPERTY(EditAnywhere, Category = Combat)
+	float EngagementSlotMargin = 40.f;
 	
 	void SpawnDefaultWeapon();
 	UPROPERTY(EditAnywhere, Category = Combat)
 	TSubclassOf<class AWeapon> WeaponClass;
 
-	// UI
+	// UI, the bar itself is drawn by ASlashHUD from UHealthBarSubsystem
 	void ToggleHealthBar(bool bShow);
 
-
-	// Components
-	UPROPERTY(VisibleAnywhere)
-	UHealthBarComponent* HealthBarWidget;
-
-	UPROPERTY(VisibleAnywhere)
-	UPawnSensingComponent* PawnSensor;
+	// Slot in UHealthBarSubsystem
+	int32 HealthBarIndex = INDEX_NONE;
 };
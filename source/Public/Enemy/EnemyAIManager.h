@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "EnemyAIManager.generated.h"
+
+class AEnemy;
+class USpatialHashSubsystem;
+
+/**
+ * Drives the AI decisions of every registered AEnemy from events instead of one actor tick per enemy.
+ * An enemy is only looked at when it or its target changed spatial hash cell, when it is close enough to its target
+ * that a radius could be crossed within a cell, or when one of its own events marked it dirty.
+ * Decisions only run when a range flag flips (EEE_RangeChanged), so idle and far away patrolling enemies cost nothing per frame.
+ */
+UCLASS()
+class SLASH_API UEnemyAIManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	bool RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+	void SetUpdateInterval(AEnemy* Enemy, float UpdateInterval);
+	void MarkDirty(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumEnemies() const { return Enemies.Num(); }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void RemoveEnemy(AEnemy* Enemy);
+	void QueueCellChanges();
+	void UpdateEnemy(int32 Index, double Now);
+	void RefreshTarget(int32 Index);
+	EEnemyRangeFlags ComputeRangeFlags(int32 Index, bool& bOutNeedsExactTest);
+	void Enqueue(int32 Index);
+	void WatchTargetHandle(int32 Index, int32 TargetHandle);
+
+	UPROPERTY()
+	USpatialHashSubsystem* SpatialHash;
+
+	// Structure of arrays, one slot per registered enemy. Slots are kept packed with RemoveAtSwap
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	TArray<TObjectKey<AActor>> Targets;
+	TArray<int32> TargetHandles;
+	TArray<bool> IsQueued;
+	TArray<bool> ForceDispatch;
+	TArray<float> UpdateIntervals;
+	TArray<double> NextUpdateTimes;
+	TArray<double> PatrolRadiiSq;
+	TArray<double> CombatRadiiSq;
+	TArray<double> AttackRadiiSq;
+	TArray<EEnemyRangeFlags> RangeFlags;
+
+	// Slots to update this frame, and the ones queued while updating for the next frame
+	TArray<int32> Queue;
+	TArray<int32> UpdatingQueue;
+
+	// Unregistered while UpdatingQueue was being walked, removed once it is done
+	UPROPERTY()
+	TArray<AEnemy*> PendingUnregisters;
+	bool bUpdating = false;
+
+	// Spatial hash handle to the enemy it belongs to, and to every enemy whose current target it is
+	TMap<int32, AEnemy*> EnemiesBySelfHandle;
+	TMultiMap<int32, AEnemy*> EnemiesByTargetHandle;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemy;
+
+struct FEnemyPerceptionStats
+{
+	int32 QueriesLastFrame = 0;
+	int32 DroppedLastFrame = 0;
+	int64 TotalQueries = 0;
+	int64 TotalDropped = 0;
+	int64 TotalDetections = 0;
+	double TotalDetectionLatency = 0.0;
+
+	FORCEINLINE double GetAverageDetectionLatency() const { return TotalDetections > 0 ? TotalDetectionLatency / TotalDetections : 0.0; }
+};
+
+/**
+ * Shared sight checks for every AEnemy, replacing one UPawnSensingComponent per enemy.
+ * Enemies are visited round robin and at most MaxTracesPerFrame async line of sight traces are issued each frame.
+ * Trace results are read back on the following frame and delivered through AEnemy::OnPawnSeen.
+ */
+UCLASS(Config = Game)
+class SLASH_API UEnemyPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void RegisterEnemy(AEnemy* Enemy, float SightRadius, float PeripheralVisionAngle, float SensingInterval);
+	void UnregisterEnemy(AEnemy* Enemy);
+	void SetSensingInterval(AEnemy* Enemy, float SensingInterval);
+
+	FORCEINLINE const FEnemyPerceptionStats& GetStats() const { return Stats; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void ResolvePendingTraces(double Now);
+	void IssueSightQueries(double Now);
+	void GatherCandidatePawns();
+
+	struct FPendingSightTrace
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TWeakObjectPtr<APawn> Pawn;
+		FTraceHandle Handle;
+		double CandidateSince = 0.0;
+	};
+
+	UPROPERTY(Config)
+	int32 MaxTracesPerFrame = 16;
+
+	// Structure of arrays, one slot per registered enemy
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	TArray<double> SightRadiiSq;
+	TArray<float> PeripheralVisionCosines;
+	TArray<float> SensingIntervals;
+	TArray<double> NextSenseTimes;
+	TArray<double> CandidateSinceTimes;
+
+	UPROPERTY()
+	TArray<APawn*> CandidatePawns;
+
+	// Candidates in range and cone of the enemy being visited
+	TArray<APawn*, TInlineAllocator<4>> VisibleCandidates;
+
+	TArray<FPendingSightTrace> PendingTraces;
+	int32 RoundRobinCursor = 0;
+	FEnemyPerceptionStats Stats;
+};
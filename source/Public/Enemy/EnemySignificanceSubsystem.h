@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+USTRUCT()
+struct FEnemySignificanceTier
+{
+	GENERATED_BODY()
+
+	// Enemies closer to the viewer than this use this tier. The last tier catches everything further away
+	UPROPERTY()
+	float MaxDistance = 0.f;
+
+	// Interval for AI decisions, the actor tick and CharacterMovement. Zero means every frame
+	UPROPERTY()
+	float TickInterval = 0.f;
+
+	// Tick interval of the skeletal mesh, which drives the animation update
+	UPROPERTY()
+	float AnimUpdateInterval = 0.f;
+
+	UPROPERTY()
+	float SensingInterval = 0.5f;
+
+	UPROPERTY()
+	bool bHealthBar = true;
+};
+
+/**
+ * Buckets every enemy into a significance tier from its distance to the viewer and whether it was rendered recently.
+ * Each tier scales the enemy's tick, animation, sensing and health bar cost.
+ * Enemies in the last tier without a CombatTarget are put fully to sleep until they are close again or take damage.
+ * Tiers are read from the [/Script/Slash.EnemySignificanceSubsystem] section of the game config.
+ */
+UCLASS(Config = Game)
+class SLASH_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+	void WakeEnemy(AEnemy* Enemy);
+
+	FORCEINLINE const TArray<int32>& GetTierCounts() const { return TierCounts; }
+	FORCEINLINE int32 GetNumAsleep() const { return NumAsleep; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	int32 ComputeTier(const AEnemy* Enemy, const FVector& ViewLocation) const;
+	void ApplyTier(int32 Index, int32 NewTier);
+	void SetAsleep(int32 Index, bool bNewAsleep);
+
+	UPROPERTY(Config)
+	TArray<FEnemySignificanceTier> Tiers;
+
+	// Enemies not rendered within this many seconds are pushed down one tier
+	UPROPERTY(Config)
+	float OffScreenGraceTime = 0.25f;
+
+	UPROPERTY(Config)
+	int32 MaxEvaluationsPerFrame = 64;
+
+	// Structure of arrays, one slot per registered enemy
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	TArray<int32> EnemyTiers;
+	TArray<bool> Asleep;
+
+	TArray<int32> TierCounts;
+	int32 NumAsleep = 0;
+	int32 EvaluationCursor = 0;
+};
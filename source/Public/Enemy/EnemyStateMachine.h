@@ -0,0 +1,243 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+enum class EEnemyRangeFlags : uint8
+{
+	None = 0,
+	InPatrolRange = 1 << 0,
+	InCombatRadius = 1 << 1,
+	InAttackRadius = 1 << 2
+};
+ENUM_CLASS_FLAGS(EEnemyRangeFlags);
+
+/** Everything that can change an enemy's decision. Between events the decision is known not to change, so nothing is polled */
+enum class EEnemyEvent : uint8
+{
+	EEE_RangeChanged,		// Entered or left the patrol, combat or attack radius of the current target
+	EEE_TargetAcquired,		// SetCombatTarget from sight or damage
+	EEE_PatrolTimerExpired,
+	EEE_AttackTimerExpired,
+	EEE_AttackEnd,
+	EEE_GetHit,
+	EEE_AttackTokenReleased,	// UCombatCoordinator freed a token for this waiting enemy
+	EEE_StunEnded,			// Events are dropped while stunned, this re-evaluates once instead. Patrols resume, fights re-check
+	EEE_Die,
+
+	EEE_MAX
+};
+
+/** Which of the existing decisions an event re-runs */
+enum class EEnemyReaction : uint8
+{
+	EER_Ignore,
+	EER_EvaluatePatrol,		// AEnemy::CheckPatrolTarget
+	EER_EvaluateCombat		// AEnemy::CheckCombatTarget
+};
+
+/**
+ * Transition table for EEnemyState, one row per (state the event is handled in, event).
+ * AllowedStates is the set of states the enemy may be in after reacting, checked at runtime in AEnemy::HandleEnemyEvent.
+ * The static_asserts below keep the table complete, ordered and free of dead ends when states or events are added.
+ */
+namespace EnemyStateMachine
+{
+	constexpr int32 NumStates = static_cast<int32>(EEnemyState::EES_MAX);
+	constexpr int32 NumEvents = static_cast<int32>(EEnemyEvent::EEE_MAX);
+
+	constexpr uint8 StateBit(EEnemyState State)
+	{
+		return static_cast<uint8>(1 << static_cast<uint8>(State));
+	}
+
+	struct FTransition
+	{
+		EEnemyState State;
+		EEnemyEvent Event;
+		EEnemyReaction Reaction;
+		uint8 AllowedStates;
+
+		constexpr bool Allows(EEnemyState NewState) const
+		{
+			return (AllowedStates & StateBit(NewState)) != 0;
+		}
+	};
+
+	namespace Detail
+	{
+		constexpr uint8 Dead = StateBit(EEnemyState::EES_Dead);
+		constexpr uint8 Idle = StateBit(EEnemyState::EES_Idle);
+		constexpr uint8 Patrolling = StateBit(EEnemyState::EES_Patrolling);
+		constexpr uint8 Chasing = StateBit(EEnemyState::EES_Chasing);
+		constexpr uint8 Waiting = StateBit(EEnemyState::EES_Waiting);
+		constexpr uint8 Attacking = StateBit(EEnemyState::EES_Attacking);
+		constexpr uint8 Engaged = StateBit(EEnemyState::EES_Engaged);
+
+		// CheckPatrolTarget always ends in Patrolling
+		constexpr uint8 AfterPatrol = Patrolling;
+		// CheckCombatTarget from anything but Engaged: lose interest, chase, start the attack timer or wait for a token
+		constexpr uint8 AfterCombat = Patrolling | Chasing | Waiting | Attacking;
+	}
+
+	inline constexpr FTransition Transitions[] =
+	{
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_Ignore, Detail::Dead },
+		{ EEnemyState::EES_Dead, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Idle },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Idle },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Idle, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Patrolling },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Patrolling },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluatePatrol, Detail::AfterPatrol },
+		{ EEnemyState::EES_Patrolling, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Chasing },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Chasing },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Chasing, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Attacking },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Attacking },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Attacking, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		// CheckCombatTarget never leaves Engaged, AttackEnd does by going through Idle first
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluateCombat, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluateCombat, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluateCombat, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_Ignore, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluateCombat, Detail::Engaged },
+		{ EEnemyState::EES_Engaged, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+
+		// Re-evaluated on range changes and when a token is freed, CheckCombatTarget then asks for the token again
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_RangeChanged, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_TargetAcquired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_PatrolTimerExpired, EEnemyReaction::EER_Ignore, Detail::Waiting },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_AttackTimerExpired, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_AttackEnd, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_GetHit, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_AttackTokenReleased, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_StunEnded, EEnemyReaction::EER_EvaluateCombat, Detail::AfterCombat },
+		{ EEnemyState::EES_Waiting, EEnemyEvent::EEE_Die, EEnemyReaction::EER_Ignore, Detail::Dead },
+	};
+
+	constexpr const FTransition& GetTransition(EEnemyState State, EEnemyEvent Event)
+	{
+		return Transitions[static_cast<int32>(State) * NumEvents + static_cast<int32>(Event)];
+	}
+
+	namespace Detail
+	{
+		constexpr bool IsComplete()
+		{
+			for (int32 Index = 0; Index < NumStates * NumEvents; ++Index)
+			{
+				const FTransition& Transition = Transitions[Index];
+				if (static_cast<int32>(Transition.State) != Index / NumEvents || static_cast<int32>(Transition.Event) != Index % NumEvents)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr bool HasNoEmptyRows()
+		{
+			for (const FTransition& Transition : Transitions)
+			{
+				if (Transition.AllowedStates == 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr bool IsDeadTerminal()
+		{
+			for (const FTransition& Transition : Transitions)
+			{
+				if (Transition.State == EEnemyState::EES_Dead && (Transition.Reaction != EEnemyReaction::EER_Ignore || Transition.AllowedStates != Dead))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr bool OnlyDieKills()
+		{
+			for (const FTransition& Transition : Transitions)
+			{
+				const bool bDie = Transition.Event == EEnemyEvent::EEE_Die;
+				if (bDie && Transition.AllowedStates != Dead)
+				{
+					return false;
+				}
+				if (!bDie && Transition.State != EEnemyState::EES_Dead && (Transition.AllowedStates & Dead) != 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr bool ReactionsMatchAllowedStates()
+		{
+			for (const FTransition& Transition : Transitions)
+			{
+				if (Transition.Reaction == EEnemyReaction::EER_EvaluatePatrol && Transition.AllowedStates != AfterPatrol)
+				{
+					return false;
+				}
+				// Ignoring an event can't change the state
+				if (Transition.Reaction == EEnemyReaction::EER_Ignore && Transition.Event != EEnemyEvent::EEE_Die && Transition.AllowedStates != StateBit(Transition.State))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	static_assert(UE_ARRAY_COUNT(Transitions) == NumStates * NumEvents, "Every (EEnemyState, EEnemyEvent) pair needs exactly one transition");
+	static_assert(Detail::IsComplete(), "Transitions must be ordered by state, then by event");
+	static_assert(Detail::HasNoEmptyRows(), "Every transition must allow at least one resulting state");
+	static_assert(Detail::IsDeadTerminal(), "Dead enemies must ignore every event");
+	static_assert(Detail::OnlyDieKills(), "Only EEnemyEvent::EEE_Die may lead to EEnemyState::EES_Dead");
+	static_assert(Detail::ReactionsMatchAllowedStates(), "Allowed states don't match what the reaction can produce");
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/LruCache.h"
+#include "NavigationData.h"
+#include "PatrolPathCache.generated.h"
+
+struct FPatrolPathKey
+{
+	TObjectKey<AActor> From;
+	TObjectKey<AActor> To;
+	uint32 AgentHash = 0;
+
+	bool operator==(const FPatrolPathKey& Other) const
+	{
+		return From == Other.From && To == Other.To && AgentHash == Other.AgentHash;
+	}
+
+	friend uint32 GetTypeHash(const FPatrolPathKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.From), GetTypeHash(Key.To)), Key.AgentHash);
+	}
+};
+
+/**
+ * Shared cache of nav paths between fixed patrol markers, keyed by (source marker, destination marker, agent properties).
+ * Cached paths are registered as active paths with the nav data, so a navmesh tile rebuild that touches a path invalidates it,
+ * and entries whose markers have moved are rebuilt. Each enemy gets its own registered copy that repaths from the enemy on invalidation.
+ * Memory is bounded by entry count and an estimated byte budget, least recently used paths are evicted first.
+ */
+UCLASS(Config = Game)
+class SLASH_API UPatrolPathCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	FNavPathSharedPtr FindOrBuildPath(const AActor* From, const AActor* To, const AActor& Querier, const FNavAgentProperties& AgentProperties, const FVector& StartLocation);
+
+	FORCEINLINE int64 GetHits() const { return Hits; }
+	FORCEINLINE int64 GetMisses() const { return Misses; }
+	FORCEINLINE float GetHitRate() const { return Hits + Misses > 0 ? static_cast<float>(Hits) / (Hits + Misses) : 0.f; }
+	FORCEINLINE int64 GetMemoryBytes() const { return MemoryBytes; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	struct FCachedPatrolPath
+	{
+		FNavPathSharedPtr Path;
+		// Marker locations the path was built between, a marker that moved since makes the entry stale
+		FVector FromLocation = FVector::ZeroVector;
+		FVector ToLocation = FVector::ZeroVector;
+		int64 Bytes = 0;
+	};
+
+	FNavPathSharedPtr BuildPath(const AActor* From, const AActor* To, const FNavAgentProperties& AgentProperties) const;
+	FNavPathSharedPtr CopyPath(const FNavigationPath& Source, const AActor& Querier, const FVector& StartLocation) const;
+	void Evict(const FPatrolPathKey& Key);
+	void EvictLeastRecent();
+
+	UPROPERTY(Config)
+	int32 MaxEntries = 256;
+
+	UPROPERTY(Config)
+	int64 MaxMemoryBytes = 1024 * 1024;
+
+	// How far a marker can move before paths to and from it are rebuilt
+	UPROPERTY(Config)
+	float MarkerMovedTolerance = 10.f;
+
+	TLruCache<FPatrolPathKey, FCachedPatrolPath> Cache;
+	int64 MemoryBytes = 0;
+	int64 Hits = 0;
+	int64 Misses = 0;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed ring of floating damage numbers. Hits on a victim that already has a number younger than the merge window are
+ * added to it, other hits take the slot at the write cursor and overwrite the oldest number once the ring is full, so a
+ * hit never searches the ring. At most
+ * MaxNewPerFrame numbers start each frame and the hits over that are dropped, so the cost of a frame is bounded by the
+ * capacity however many hits land. UCombatTextSubsystem owns the world's buffer and feeds it from ABaseCharacter::HandleDamage.
+ */
+class SLASH_API FCombatTextBuffer
+{
+public:
+	struct FEntry
+	{
+		FVector Location = FVector::ZeroVector;
+		uint32 VictimId = 0;
+		float Amount = 0.f;
+		// Starts past any lifetime, so unused slots read as expired
+		float Age = MAX_flt;
+	};
+
+	void Init(int32 Capacity, int32 InMaxNewPerFrame);
+
+	// Returns false when the hit was dropped by the per frame budget
+	bool Add(uint32 VictimId, const FVector& Location, float Amount, float MergeWindow);
+	void Advance(float DeltaTime);
+	void Reset();
+
+	FORCEINLINE int32 Capacity() const { return Entries.Num(); }
+	FORCEINLINE const FEntry& GetEntry(int32 Index) const { return Entries[Index]; }
+	FORCEINLINE int32 GetNumDropped() const { return NumDropped; }
+
+private:
+	TArray<FEntry> Entries;
+	// Slot of each victim's newest number, dropped when the cursor overwrites it
+	TMap<uint32, int32> VictimSlots;
+	// Write cursor, the oldest slot
+	int32 Head = 0;
+	int32 MaxNewPerFrame = 0;
+	int32 NumNewThisFrame = 0;
+	int32 NumDropped = 0;
+};
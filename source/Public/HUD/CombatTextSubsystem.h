@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HUD/CombatTextBuffer.h"
+#include "HUD/HUDProjection.h"
+#include "CombatTextSubsystem.generated.h"
+
+/** One damage number to draw this frame, in viewport pixels */
+struct FCombatTextDraw
+{
+	FVector2D ScreenPosition = FVector2D::ZeroVector;
+	int32 Amount = 0;
+	float Opacity = 1.f;
+};
+
+/**
+ * Floating damage numbers fed by ABaseCharacter::HandleDamage, kept in a fixed FCombatTextBuffer.
+ * ASlashHUD projects the live numbers once per frame, culling the ones off screen or past MaxDrawDistance, and draws them
+ * with a single SCombatTextLayer. Settings come from [/Script/Slash.CombatTextSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UCombatTextSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void AddDamage(const AActor* Victim, float Damage);
+
+	// See HUDProjection::ProjectToViewport
+	void ProjectText(const HUDProjection::FView& View, TArray<FCombatTextDraw>& OutDraws) const;
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	UPROPERTY(Config)
+	int32 Capacity = 64;
+
+	UPROPERTY(Config)
+	int32 MaxNewPerFrame = 16;
+
+	// Hits on the same victim within this many seconds of its number appearing add to it
+	UPROPERTY(Config)
+	float MergeWindow = 0.3f;
+
+	UPROPERTY(Config)
+	float Lifetime = 1.f;
+
+	// The last part of the lifetime fades out
+	UPROPERTY(Config)
+	float FadeTime = 0.3f;
+
+	UPROPERTY(Config)
+	float RiseSpeed = 80.f;
+
+	// Above the victim's collision top
+	UPROPERTY(Config)
+	float HeightOffset = 30.f;
+
+	UPROPERTY(Config)
+	double MaxDrawDistance = 3000.0;
+
+	FCombatTextBuffer Buffer;
+};
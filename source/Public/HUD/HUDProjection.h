@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCanvas;
+struct FGeometry;
+
+/**
+ * World to screen placement shared by the HUD layers that draw many markers at once, health bars and combat text.
+ * ASlashHUD takes the canvas' scene view matrices once per frame, so the matrices the frame already built are reused, and
+ * every marker is projected with them into viewport pixels, the same result as UCanvas::Project.
+ * The Slate layers turn those into their own space by the geometry's scale, which is the DPI scale of the viewport.
+ */
+namespace HUDProjection
+{
+	struct FView
+	{
+		FMatrix ViewProjection = FMatrix::Identity;
+		FVector ViewLocation = FVector::ZeroVector;
+		FVector2D ViewportSize = FVector2D::ZeroVector;
+	};
+
+	// False when the canvas has no scene view to project with
+	SLASH_API bool MakeView(const UCanvas* Canvas, const FVector& ViewLocation, FView& OutView);
+
+	// False when Location is past MaxDistanceSquared from the view, behind it, or off the viewport
+	SLASH_API bool ProjectToViewport(const FView& View, const FVector& Location, double MaxDistanceSquared, FVector2D& OutScreenPosition);
+
+	SLASH_API FVector2D ViewportToLayer(const FVector2D& ScreenPosition, const FGeometry& LayerGeometry);
+}
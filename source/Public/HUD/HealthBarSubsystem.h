@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Algo/Count.h"
+#include "HUD/HUDProjection.h"
+#include "HealthBarSubsystem.generated.h"
+
+class AEnemy;
+
+/** One bar to draw this frame, in viewport pixels */
+struct FHealthBarDraw
+{
+	FVector2D ScreenPosition = FVector2D::ZeroVector;
+	float Percent = 1.f;
+};
+
+/**
+ * Health of every enemy that can show a bar, without a widget component per enemy.
+ * Enemies register once and their attribute component's OnHealthChanged keeps the percent current. ASlashHUD projects the
+ * shown bars once per frame and draws them all with a single SHealthBarLayer.
+ * A bar is drawn when the enemy has been hit, is still damaged, its significance tier allows bars, and it is on screen within
+ * MaxDrawDistance. Settings come from [/Script/Slash.HealthBarSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+	void SetShown(AEnemy* Enemy, bool bShown);
+	void SetEnabled(AEnemy* Enemy, bool bEnabled);
+
+	// See HUDProjection::ProjectToViewport
+	void ProjectBars(const HUDProjection::FView& View, TArray<FHealthBarDraw>& OutBars) const;
+
+	FORCEINLINE int32 GetNumRegistered() const { return Enemies.Num(); }
+	FORCEINLINE int32 GetNumShown() const { return Algo::Count(IsShown, true); }
+	FORCEINLINE int32 GetNumDrawnLastFrame() const { return NumDrawnLastFrame; }
+	SIZE_T GetAllocatedSize() const;
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void OnHealthChanged(float Percent, AEnemy* Enemy);
+
+	UPROPERTY(Config)
+	double MaxDrawDistance = 3000.0;
+
+	// Above the capsule's top
+	UPROPERTY(Config)
+	float BarHeightOffset = 20.f;
+
+	// Parallel, an enemy's slot is AEnemy::HealthBarIndex
+	TArray<AEnemy*> Enemies;
+	TArray<float> HeightOffsets;
+	TArray<float> Percents;
+	TArray<bool> IsShown;
+	TArray<bool> IsEnabled;
+	TArray<FDelegateHandle> HealthChangedHandles;
+
+	mutable int32 NumDrawnLastFrame = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "Fonts/SlateFontInfo.h"
+#include "Styling/CoreStyle.h"
+#include "HUD/CombatTextSubsystem.h"
+
+/**
+ * Viewport-sized leaf widget that paints every floating damage number in one pass.
+ * Holds no per-number widgets; ASlashHUD hands it the projected numbers each frame.
+ */
+class SLASH_API SCombatTextLayer : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SCombatTextLayer)
+		: _Font(FCoreStyle::GetDefaultFontStyle("Bold", 18))
+		, _Color(FLinearColor(1.f, 0.9f, 0.4f))
+	{
+		_Visibility = EVisibility::HitTestInvisible;
+	}
+		SLATE_ARGUMENT(FSlateFontInfo, Font)
+		SLATE_ARGUMENT(FLinearColor, Color)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// Swapped in, so the caller's array keeps its allocation for the next frame
+	void SetDraws(TArray<FCombatTextDraw>& InDraws);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+		int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	TArray<FCombatTextDraw> Draws;
+	FSlateFontInfo Font;
+	FLinearColor Color;
+
+	// Reused while painting
+	mutable FString Text;
+};
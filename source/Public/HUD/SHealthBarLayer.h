@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "HUD/HealthBarSubsystem.h"
+
+/**
+ * Viewport-sized leaf widget that paints every enemy health bar as two boxes, background and fill, in one pass.
+ * Holds no per-enemy widgets; ASlashHUD hands it the projected bars each frame.
+ */
+class SLASH_API SHealthBarLayer : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHealthBarLayer)
+		: _BarSize(FVector2D(80.f, 8.f))
+		, _FillColor(FLinearColor(0.8f, 0.05f, 0.05f))
+		, _BackgroundColor(FLinearColor(0.f, 0.f, 0.f, 0.6f))
+	{
+		_Visibility = EVisibility::HitTestInvisible;
+	}
+		SLATE_ARGUMENT(FVector2D, BarSize)
+		SLATE_ARGUMENT(FLinearColor, FillColor)
+		SLATE_ARGUMENT(FLinearColor, BackgroundColor)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// Swapped in, so the caller's array keeps its allocation for the next frame
+	void SetBars(TArray<FHealthBarDraw>& InBars);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+		int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	TArray<FHealthBarDraw> Bars;
+	FVector2D BarSize;
+	FLinearColor FillColor;
+	FLinearColor BackgroundColor;
+	const FSlateBrush* Brush = nullptr;
+};
@@ -4,9 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "HUD/CombatTextSubsystem.h"
+#include "HUD/HealthBarSubsystem.h"
+#include "Styling/CoreStyle.h"
 #include "SlashHUD.generated.h"
 
 class USlashOverlay;
+class SCombatTextLayer;
+class SHealthBarLayer;
 
 UCLASS()
 class SLASH_API ASlashHUD : public AHUD
@@ -18,10 +23,33 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void DrawHUD() override;
+
 private:
 	UPROPERTY(EditDefaultsOnly, Category = Slash)
 	TSubclassOf<USlashOverlay> SlashOverlayClass;
 
 	UPROPERTY()
 	USlashOverlay* SlashOverlay;
+
+	// Every enemy health bar, drawn by one widget from the bars projected in DrawHUD
+	TSharedPtr<SHealthBarLayer> HealthBarLayer;
+	TArray<FHealthBarDraw> HealthBars;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Slash|Health Bars")
+	FVector2D HealthBarSize = FVector2D(80.f, 8.f);
+	UPROPERTY(EditDefaultsOnly, Category = "Slash|Health Bars")
+	FLinearColor HealthBarFillColor = FLinearColor(0.8f, 0.05f, 0.05f);
+	UPROPERTY(EditDefaultsOnly, Category = "Slash|Health Bars")
+	FLinearColor HealthBarBackgroundColor = FLinearColor(0.f, 0.f, 0.f, 0.6f);
+
+	// Every floating damage number, drawn by one widget from the numbers projected in DrawHUD
+	TSharedPtr<SCombatTextLayer> CombatTextLayer;
+	TArray<FCombatTextDraw> CombatTexts;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Slash|Combat Text")
+	FSlateFontInfo CombatTextFont = FCoreStyle::GetDefaultFontStyle("Bold", 18);
+	UPROPERTY(EditDefaultsOnly, Category = "Slash|Combat Text")
+	FLinearColor CombatTextColor = FLinearColor(1.f, 0.9f, 0.4f);
 };
@@ -6,20 +6,47 @@
 #include "Blueprint/UserWidget.h"
 #include "SlashOverlay.generated.h"
 
+class UAttributeComponent;
+class UInvalidationBox;
 class UProgressBar;
 class UTextBlock;
 
+/**
+ * Player HUD driven by the attribute component's change delegates instead of per-frame pushes.
+ * Changes are only recorded when they arrive, and everything that changed during a frame is written to the widgets once
+ * at the start of the next tick. Numbers are formatted only when they differ from what is shown.
+ * The widget blueprint should keep its content under an Invalidation Box named InvalidationRoot, so widgets that didn't change
+ * are cached and cost nothing in Slate prepass or paint.
+ */
 UCLASS()
 class SLASH_API USlashOverlay : public UUserWidget
 {
 	GENERATED_BODY()
 
 public:
+	void BindAttributes(UAttributeComponent* Attributes);
+	void UnbindAttributes();
+
 	void SetHealthBarPercent(float Percent);
 	void SetStaminaBarPercent(float Percent);
 	void SetCoinsValue(int32 Coins);
 	void SetSoulsValue(int32 Souls);
+
+protected:
+	virtual void NativeOnInitialized() override;
+	virtual void NativeDestruct() override;
+
 private:
+	void OnHealthChanged(float Percent);
+	void OnStaminaChanged(float Percent);
+	void OnGoldChanged(int32 Gold);
+	void OnSoulsChanged(int32 Souls);
+	void RequestFlush();
+	void FlushChanges();
+
+		UPROPERTY(meta = (BindWidgetOptional))
+		UInvalidationBox* InvalidationRoot;
+
 		UPROPERTY(meta = (BindWidget))
 		UProgressBar* HealthProgressBar;
 
@@ -33,4 +60,22 @@ private:
 		UPROPERTY(meta = (BindWidget))
 		UTextBlock* SoulsText;
 
+	TWeakObjectPtr<UAttributeComponent> BoundAttributes;
+	FDelegateHandle HealthChangedHandle;
+	FDelegateHandle StaminaChangedHandle;
+	FDelegateHandle GoldChangedHandle;
+	FDelegateHandle SoulsChangedHandle;
+
+	// Latest values from the delegates, written to the widgets by FlushChanges
+	float PendingHealthPercent = 1.f;
+	float PendingStaminaPercent = 1.f;
+	int32 PendingCoins = 0;
+	int32 PendingSouls = 0;
+	bool bFlushRequested = false;
+
+	// What the widgets show, -1 until first written
+	float ShownHealthPercent = -1.f;
+	float ShownStaminaPercent = -1.f;
+	int32 ShownCoins = -1;
+	int32 ShownSouls = -1;
 };
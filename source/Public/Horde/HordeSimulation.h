@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+struct FHordeSettings
+{
+	double WanderRadius = 1000.0;
+	double PatrolRadius = 200.0;
+	double SightRadius = 3000.0;
+	double CombatRadius = 4000.0;
+	double AttackRadius = 150.0;
+	float PatrolWalkSpeed = 125.f;
+	float ChaseWalkSpeed = 300.f;
+	float AttackDelay = 0.5f;
+	float AttackDuration = 1.f;
+};
+
+/**
+ * Lightweight horde enemies stored as structure of arrays, one array per fragment.
+ * Each processor runs over the entities in its state only and mirrors AEnemy's patrol, chase and attack decisions
+ * with straight line movement on the XY plane instead of navigation. Promoted entities are driven by their AEnemy and skipped.
+ * UHordeSubsystem owns one per world and hands entities near the player over to pooled AEnemy actors.
+ */
+class SLASH_API FHordeSimulation
+{
+public:
+	explicit FHordeSimulation(int32 Seed = 0);
+
+	int32 Add(const FVector& Location, float HealthPercent = 1.f);
+	void RemoveAtSwap(int32 Index);
+	void Reset();
+
+	void Tick(float DeltaTime, const FVector& TargetLocation, bool bHasTarget);
+
+	FORCEINLINE int32 Num() const { return Locations.Num(); }
+
+	FHordeSettings Settings;
+
+	// Fragments
+	TArray<FVector> Locations;
+	TArray<float> Yaws;
+	TArray<EEnemyState> States;
+	TArray<float> HealthPercents;
+	TArray<FVector> Homes;
+	TArray<FVector> PatrolGoals;
+	TArray<float> Timers;
+	TArray<bool> IsPromoted;
+
+private:
+	void ProcessPerception(const FVector& TargetLocation);
+	void ProcessPatrol(float DeltaTime);
+	void ProcessChase(float DeltaTime, const FVector& TargetLocation);
+	void ProcessAttack(float DeltaTime, const FVector& TargetLocation);
+	void ProcessLoseTarget();
+	void MoveTowards(int32 Index, const FVector& Goal, float Speed, float DeltaTime);
+	FVector PickPatrolGoal(int32 Index);
+
+	FRandomStream Random;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Horde/HordeSimulation.h"
+#include "HordeSubsystem.generated.h"
+
+class AEnemy;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Horde mode: thousands of enemies simulated by FHordeSimulation and drawn as instances of a single static mesh.
+ * The mesh's material can read the enemy state from per instance custom data to play a shared, baked animation.
+ * Entities within PromoteRadius of the player are swapped for a pooled AEnemy with full AI and combat, and swapped back
+ * once the actor is beyond DemoteRadius and out of combat. Settings come from [/Script/Slash.HordeSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UHordeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	void SpawnHorde(const FVector& Center, double Radius, int32 Count);
+	void ClearHorde();
+
+	FORCEINLINE int32 GetNumEntities() const { return Simulation.Num(); }
+	FORCEINLINE int32 GetNumPromoted() const { return NumPromoted; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void UpdatePromotions(APawn* PlayerPawn);
+	void Promote(int32 Index, APawn* PlayerPawn);
+	void Demote(int32 Index);
+	void RemoveEntity(int32 Index);
+	void UpdateInstances();
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AEnemy> EnemyClass;
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UStaticMesh> InstanceMesh;
+
+	UPROPERTY(Config)
+	double PromoteRadius = 2000.0;
+
+	// Larger than PromoteRadius so an enemy on the boundary doesn't swap back and forth
+	UPROPERTY(Config)
+	double DemoteRadius = 2500.0;
+
+	UPROPERTY(Config)
+	int32 MaxPromoted = 48;
+
+	// Seconds between instance transform uploads, zero means every frame
+	UPROPERTY(Config)
+	float InstanceUpdateInterval = 0.f;
+
+	UPROPERTY(Config)
+	double SightRadius = 3000.0;
+
+	UPROPERTY(Config)
+	double CombatRadius = 4000.0;
+
+	UPROPERTY()
+	UClass* LoadedEnemyClass;
+
+	UPROPERTY()
+	AActor* InstanceHost;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances;
+
+	FHordeSimulation Simulation;
+
+	// Parallel to the simulation's fragments, set while the entity is promoted
+	TArray<TWeakObjectPtr<AEnemy>> PromotedEnemies;
+	int32 NumPromoted = 0;
+
+	TArray<FTransform> InstanceTransforms;
+	TArray<EEnemyState> RenderedStates;
+	double NextInstanceUpdateTime = 0.0;
+};
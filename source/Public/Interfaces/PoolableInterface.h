@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PoolableInterface.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UPoolableInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors recycled by UActorPoolSubsystem.
+ * The subsystem hides the actor and turns off its collision and tick, these hooks handle everything specific to the class.
+ */
+class SLASH_API IPoolableInterface
+{
+	GENERATED_BODY()
+
+public:
+	// Reset to the state of a freshly spawned actor. Called after the actor was moved to its new transform
+	virtual void OnAcquiredFromPool();
+	// Stop timers, montages, movement and unregister from anything that would still reference the actor
+	virtual void OnReleasedToPool();
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Interfaces/PoolableInterface.h"
 #include "Item.generated.h"
 
 class USphereComponent;
@@ -16,7 +17,7 @@ enum class EItemState : uint8
 };
 
 UCLASS()
-class SLASH_API AItem : public AActor
+class SLASH_API AItem : public AActor, public IPoolableInterface
 {
 	GENERATED_BODY()
 	
@@ -25,10 +26,16 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	UStaticMeshComponent* GetMesh();
 
+	/** IPoolableInterface */
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+	/** /IPoolableInterface */
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void SpawnPickupSystem();
 	virtual void SpawnPickupSound();
+	void ReleaseToPool();
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sin Parameters")
 		float _amplitude = 0.25f;
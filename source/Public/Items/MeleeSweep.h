@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The blade's trace line at one instant, from BoxTraceStart to BoxTraceEnd */
+struct FMeleeBladePose
+{
+	FVector Base = FVector::ZeroVector;
+	FVector Tip = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	static FMeleeBladePose Lerp(const FMeleeBladePose& From, const FMeleeBladePose& To, double Alpha)
+	{
+		return { FMath::Lerp(From.Base, To.Base, Alpha), FMath::Lerp(From.Tip, To.Tip, Alpha), FQuat::Slerp(From.Rotation, To.Rotation, Alpha) };
+	}
+};
+
+/**
+ * Continuous melee hit detection for one swing. The blade is sampled at fixed swing times (SubStepRate per second)
+ * interpolated between the poses of the frames around them, so how often the blade is traced doesn't depend on frame rate
+ * and fast swings can't pass through a target between two frames.
+ * Each sample gets one multi-hit trace along the blade. Actors already hit this swing are kept in a fixed-capacity set
+ * that never allocates and is cleared when the next swing begins.
+ * AWeapon drives one per swing when bSweepMelee is set, Slash.Items.MeleeSweep.FrameRateIndependence checks the hits at 20, 60 and 144 FPS.
+ */
+class SLASH_API FMeleeSweep
+{
+public:
+	static constexpr int32 MaxHitsPerSwing = 16;
+
+	void Begin(const FMeleeBladePose& Pose, float InSubStepRate);
+	void End();
+
+	/// <summary>
+	/// Moves the blade to Pose over DeltaTime and calls Trace(const FMeleeBladePose&) for every sub-step sample in between.
+	/// Stops early if a trace ends the swing
+	/// </summary>
+	template <typename TraceFunc>
+	void Advance(float DeltaTime, const FMeleeBladePose& Pose, TraceFunc&& Trace)
+	{
+		if (!bActive)
+		{
+			return;
+		}
+
+		const double FrameEndTime = PoseTime + DeltaTime;
+		for (double SampleTime = NextSample / SubStepRate; bActive && SampleTime <= FrameEndTime; SampleTime = ++NextSample / SubStepRate)
+		{
+			const double Alpha = DeltaTime > 0.f ? (SampleTime - PoseTime) / DeltaTime : 1.0;
+			Trace(FMeleeBladePose::Lerp(PreviousPose, Pose, FMath::Clamp(Alpha, 0.0, 1.0)));
+		}
+		PreviousPose = Pose;
+		PoseTime = FrameEndTime;
+	}
+
+	bool MarkHit(const AActor* Actor);
+
+	FORCEINLINE bool IsActive() const { return bActive; }
+	FORCEINLINE int32 GetNumSamples() const { return NextSample; }
+	FORCEINLINE const TArray<const AActor*, TFixedAllocator<MaxHitsPerSwing>>& GetHitActors() const { return HitActors; }
+
+private:
+	FMeleeBladePose PreviousPose;
+	double PoseTime = 0.0;
+	double SubStepRate = 120.0;
+	int32 NextSample = 0;
+	bool bActive = false;
+
+	TArray<const AActor*, TFixedAllocator<MaxHitsPerSwing>> HitActors;
+};
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Item.h"
+#include "Items/MeleeSweep.h"
+#include "CollisionQueryParams.h"
 #include "Weapon.generated.h"
 
 class USoundBase;
@@ -14,6 +16,12 @@ class SLASH_API AWeapon : public AItem
 
 public:
 	AWeapon();
+	virtual void Tick(float DeltaTime) override;
+
+	/** IPoolableInterface */
+	virtual void OnReleasedToPool() override;
+	/** /IPoolableInterface */
+
 	void Equip(USceneComponent* InParent, FName SocketName, AActor* NewOwner, APawn* NewInstigator);
 	void AttachMeshToSocket(USceneComponent* InParent, const FName& SocketName);
 	void SetWeaponCollisionEnable(ECollisionEnabled::Type CollisionEnabled);
@@ -43,11 +51,37 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
 	bool bShowBoxDebug = false;
 
+	// Trace the blade continuously while collision is enabled instead of waiting for WeaponBox overlaps.
+	// Characters are hit through their hitboxes, which don't generate overlaps, so without it WeaponBox only fires for actors like breakables
+	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
+	bool bSweepMelee = true;
+	// Blade samples per second of swing, high enough that the blade moves less than its width between samples
+	UPROPERTY(EditAnywhere, Category = "Weapon Properties", meta = (EditCondition = "bSweepMelee", ClampMin = "30"))
+	float MeleeSubStepRate = 120.f;
+
+	friend class UWeaponTraceSubsystem;
+
 	void ExecuteOnIHitInterface(AActor* HitActor, FHitResult& BoxHit);
 	void BoxTrace(FHitResult& BoxHit);
+	void ApplyHit(AActor* HitActor, FHitResult& Hit);
+	void ResolveTrace(uint32 TraceSwingId, TArray<FHitResult>& Hits);
+
+	// Bumped whenever a swing starts or the weapon is pooled, so late async results of an old swing are dropped
+	uint32 SwingId = 0;
+
+	// Swept melee
+	FMeleeBladePose GetBladePose() const;
+	void BeginMeleeSweep();
+	void TraceMeleeSample(const FMeleeBladePose& Pose);
+	FMeleeSweep MeleeSweep;
+	FCollisionQueryParams MeleeQueryParams;
+	FCollisionResponseParams MeleeResponseParams;
+	TArray<FHitResult> MeleeHits;
 
 	TArray<AActor*> ActorsHitThisAttack;
 
 public:
 	FORCEINLINE UBoxComponent* GetWeaponBox() const { return WeaponBox; }
+	FORCEINLINE USceneComponent* GetBoxTraceStart() const { return BoxTraceStart; }
+	FORCEINLINE USceneComponent* GetBoxTraceEnd() const { return BoxTraceEnd; }
 };
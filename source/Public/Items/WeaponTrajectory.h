@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Items/MeleeSweep.h"
+#include "WeaponTrajectory.generated.h"
+
+class ABaseCharacter;
+class AWeapon;
+
+/** Blade pose in the owning actor's space */
+USTRUCT()
+struct FWeaponTrajectorySample
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector3f Base = FVector3f::ZeroVector;
+	UPROPERTY()
+	FVector3f Tip = FVector3f::ZeroVector;
+	UPROPERTY()
+	FQuat4f Rotation = FQuat4f::Identity;
+};
+
+/** The blade's path through one attack montage section, sampled at a fixed rate from the section start */
+USTRUCT()
+struct FWeaponTrajectorySection
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	FName Section;
+	UPROPERTY(VisibleAnywhere)
+	float SampleRate = 60.f;
+	UPROPERTY()
+	TArray<FWeaponTrajectorySample> Samples;
+};
+
+/**
+ * Weapon blade trajectories baked in the editor from CharacterClass's AttackMontage, one per AttackMontageSections entry,
+ * for WeaponClass held in SocketName.
+ * At runtime the blade pose is the baked curve at the swing's section time, moved by the actor transform, so swings are traced
+ * without waiting for the skeletal pose. Enemies whose animation is throttled or skipped still hit, and sampling only reads
+ * this asset and the actor transform so it is safe off the game thread.
+ */
+UCLASS(BlueprintType)
+class SLASH_API UWeaponTrajectoryAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	bool SampleBlade(FName Section, float Time, FMeleeBladePose& OutPose) const;
+	bool IsBakedFor(const AWeapon* Weapon) const;
+
+#if WITH_EDITOR
+	UFUNCTION(CallInEditor, Category = "Bake")
+	void Bake();
+#endif
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	TSubclassOf<ABaseCharacter> CharacterClass;
+
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	TSubclassOf<AWeapon> WeaponClass;
+
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	FName SocketName = FName("WeaponSocket");
+
+	UPROPERTY(EditAnywhere, Category = "Bake", meta = (ClampMin = "10"))
+	float SampleRate = 60.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Trajectories")
+	TArray<FWeaponTrajectorySection> Sections;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorPoolSubsystem.generated.h"
+
+USTRUCT()
+struct FActorPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSoftClassPtr<AActor> ActorClass;
+
+	UPROPERTY()
+	int32 Count = 0;
+};
+
+USTRUCT()
+struct FActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+};
+
+/**
+ * Recycles actors instead of destroying and respawning them.
+ * Released actors are hidden, lose collision and tick, and are parked until acquired again. Classes implementing
+ * IPoolableInterface reset themselves in OnAcquiredFromPool / OnReleasedToPool, anything else is simply destroyed on release.
+ * Pools listed in the [/Script/Slash.ActorPoolSubsystem] config section are pre-warmed a few spawns per frame after the world begins play.
+ * Short lived actors such as loot can be requested with RequestSpawn, requests are drained at MaxDeferredSpawnsPerFrame.
+ */
+UCLASS(Config = Game)
+class SLASH_API UActorPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	/** UWorldSubsystem */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	/** /UWorldSubsystem */
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** /FTickableGameObject */
+
+	AActor* AcquireActor(UClass* ActorClass, const FTransform& Transform);
+	void ReleaseActor(AActor* Actor);
+	void RequestPrewarm(UClass* ActorClass, int32 Count);
+	void AddCorpse(AActor* Actor, float LifeSpan);
+	void RequestSpawn(UClass* ActorClass, const FTransform& Transform);
+
+	template<class T>
+	T* Acquire(TSubclassOf<T> ActorClass, const FTransform& Transform)
+	{
+		return Cast<T>(AcquireActor(ActorClass, Transform));
+	}
+
+	int32 GetNumFree(UClass* ActorClass) const;
+	FORCEINLINE int32 GetNumCorpses() const { return Corpses.Num(); }
+	FORCEINLINE int32 GetNumPendingSpawns() const { return PendingSpawns.Num() - PendingSpawnsHead; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	struct FCorpse
+	{
+		TWeakObjectPtr<AActor> Actor;
+		double ReleaseTime = 0.0;
+	};
+
+	AActor* SpawnPooledActor(UClass* ActorClass, const FTransform& Transform);
+	void SetActorPooled(AActor* Actor, bool bPooled);
+	void TickPrewarm();
+	void TickCorpses();
+	void TickPendingSpawns();
+
+	UPROPERTY(Config)
+	TArray<FActorPoolPrewarm> Prewarm;
+
+	// Time spent pre-warming per frame, in milliseconds
+	UPROPERTY(Config)
+	float PrewarmBudgetMs = 2.f;
+
+	// Dead enemies left lying around, the oldest is recycled early when another one dies
+	UPROPERTY(Config)
+	int32 MaxVisibleCorpses = 16;
+
+	// Deferred spawn requests acquired per frame, the rest wait for the next frame
+	UPROPERTY(Config)
+	int32 MaxDeferredSpawnsPerFrame = 8;
+
+	// Where released actors are parked, away from gameplay and above any kill Z
+	UPROPERTY(Config)
+	FVector ParkingLocation = FVector(0.f, 0.f, 100000.f);
+
+	UPROPERTY()
+	TMap<UClass*, FActorPool> Pools;
+
+	TArray<TPair<UClass*, int32>> PendingPrewarm;
+	TArray<FCorpse> Corpses;
+	TArray<TPair<UClass*, FTransform>> PendingSpawns;
+	int32 PendingSpawnsHead = 0;
+};
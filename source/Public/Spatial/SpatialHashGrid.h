@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform hash grid over the XY plane.
+ * Entries are addressed by a stable handle; Update only touches the cell buckets when an entry crosses a cell boundary.
+ * Cells are 2D so any cell based bound is a lower bound on the real 3D distance.
+ */
+class SLASH_API FSpatialHashGrid
+{
+public:
+	explicit FSpatialHashGrid(double InCellSize = 500.0);
+
+	int32 Add(const FVector& Location);
+	void Remove(int32 Handle);
+	bool Update(int32 Handle, const FVector& Location);
+	void Reset();
+
+	void QueryRadiusSq(const FVector& Center, double RadiusSq, TArray<int32>& OutHandles) const;
+	bool MayBeWithinRadiusSq(int32 HandleA, int32 HandleB, double RadiusSq) const;
+	double GetCellDistanceLowerBoundSq(const FIntPoint& CellA, const FIntPoint& CellB) const;
+	FIntPoint GetCell(const FVector& Location) const;
+
+	bool HasCellChangedSince(int32 Handle, uint64 Frame) const;
+	const TArray<int32>& GetCellChangesThisFrame() const;
+
+	FORCEINLINE bool IsValidHandle(int32 Handle) const { return Entries.IsValidIndex(Handle) && Entries[Handle].bInUse; }
+	FORCEINLINE const FVector& GetLocation(int32 Handle) const { return Entries[Handle].Location; }
+	FORCEINLINE const FIntPoint& GetEntryCell(int32 Handle) const { return Entries[Handle].Cell; }
+	FORCEINLINE double GetCellSize() const { return CellSize; }
+	FORCEINLINE int32 Num() const { return Entries.Num() - FreeHandles.Num(); }
+
+private:
+	struct FEntry
+	{
+		FVector Location = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		uint64 CellChangedFrame = 0;
+		bool bInUse = false;
+	};
+
+	void AddToCell(int32 Handle, const FIntPoint& Cell);
+	void RemoveFromCell(int32 Handle, const FIntPoint& Cell);
+	void RecordCellChange(int32 Handle);
+
+	double CellSize;
+	double InvCellSize;
+	TArray<FEntry> Entries;
+	TArray<int32> FreeHandles;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// Handles whose cell changed during CellChangesFrame, lazily reset when the frame counter moves on
+	mutable TArray<int32> CellChanges;
+	mutable uint64 CellChangesFrame = 0;
+};
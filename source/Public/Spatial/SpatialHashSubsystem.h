@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Spatial/SpatialHashGrid.h"
+#include "SpatialHashSubsystem.generated.h"
+
+/**
+ * World wide spatial hash of pawns and patrol markers.
+ * Tracked actors are moved in the grid from their root component's TransformUpdated event so the grid stays current without polling.
+ * Actors are reference counted since many enemies share the same patrol markers.
+ */
+UCLASS(Config = Game)
+class SLASH_API USpatialHashSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** USubsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** /USubsystem */
+
+	int32 RegisterActor(AActor* Actor);
+	void UnregisterActor(AActor* Actor);
+	int32 FindHandle(const AActor* Actor) const;
+
+	bool IsWithinRadiusSq(int32 HandleA, int32 HandleB, double RadiusSq) const;
+
+	FORCEINLINE const FSpatialHashGrid& GetGrid() const { return Grid; }
+
+protected:
+	/** UWorldSubsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	/** /UWorldSubsystem */
+
+private:
+	void OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Handle);
+
+	struct FTrackedActor
+	{
+		int32 Handle = INDEX_NONE;
+		int32 RefCount = 0;
+		TWeakObjectPtr<USceneComponent> Root;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	UPROPERTY(Config)
+	float CellSize = 500.f;
+
+	FSpatialHashGrid Grid;
+	TMap<TObjectKey<AActor>, FTrackedActor> TrackedActors;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+// Frame step the slash.*.Benchmark commands simulate at
+constexpr float SlashBenchmarkDeltaTime = 1.f / 60.f;
+
+/** Average, worst and over budget frame times of one benchmark run, timed with Begin/End around each frame's work */
+struct FSlashBenchmarkTimer
+{
+	explicit FSlashBenchmarkTimer(double InBudgetMs = 0.0)
+		: BudgetMs(InBudgetMs)
+	{
+	}
+
+	FORCEINLINE void Begin() { StartSeconds = FPlatformTime::Seconds(); }
+
+	FORCEINLINE double End()
+	{
+		const double FrameMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+		TotalMs += FrameMs;
+		WorstMs = FMath::Max(WorstMs, FrameMs);
+		NumOverBudget += BudgetMs > 0.0 && FrameMs > BudgetMs ? 1 : 0;
+		++NumFrames;
+		return FrameMs;
+	}
+
+	FORCEINLINE double GetAverageMs() const { return TotalMs / FMath::Max(NumFrames, 1); }
+
+	// "avg 0.123 ms, worst 0.456 ms", with the frames over budget when there is one
+	FString ToString() const
+	{
+		FString Result = FString::Printf(TEXT("avg %.3f ms, worst %.3f ms"), GetAverageMs(), WorstMs);
+		if (BudgetMs > 0.0)
+		{
+			Result += FString::Printf(TEXT(", %d frames over %.2f ms"), NumOverBudget, BudgetMs);
+		}
+		return Result;
+	}
+
+	double BudgetMs = 0.0;
+	double TotalMs = 0.0;
+	double WorstMs = 0.0;
+	int32 NumFrames = 0;
+	int32 NumOverBudget = 0;
+
+private:
+	double StartSeconds = 0.0;
+};
+
+/**
+ * Registers slash.<Name>.Benchmark [Frames]. Run is handed the frame count, 600 by default, and logs its own results.
+ * The simulations these time don't need a world, so the commands also work from a headless -nullrhi run.
+ */
+class FSlashBenchmarkCommand
+{
+public:
+	FSlashBenchmarkCommand(const TCHAR* Name, const TCHAR* Description, TFunction<void(int32 NumFrames)> Run)
+		: Command(*FString::Printf(TEXT("slash.%s.Benchmark"), Name),
+			*FString::Printf(TEXT("%s. Usage: slash.%s.Benchmark [Frames]"), Description, Name),
+			FConsoleCommandWithArgsDelegate::CreateLambda([Run = MoveTemp(Run)](const TArray<FString>& Args)
+			{
+				Run(Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 600);
+			}))
+	{
+	}
+
+private:
+	FAutoConsoleCommand Command;
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Engine/EngineTypes.h"
+
+// Hitbox shapes are this object type and only respond to it, and weapon sweeps trace on it.
+// Declared as the "Hitbox" object channel in Config/DefaultEngine.ini, ignored by everything else by default
+#define ECC_Hitbox ECC_GameTraceChannel1